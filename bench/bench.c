@@ -0,0 +1,143 @@
+#include "bench.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_SAMPLES 300
+#define BENCH_DEFAULT_BATCH 64
+#define BENCH_QUICK_SAMPLES 5
+
+static volatile uint64_t bench_sink;
+static bool bench_first_record;
+static int bench_failed_checks;
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+void bench_consume(uint64_t value)
+{
+    bench_sink += value;
+}
+
+bool bench_check(bool condition, const char *format, ...)
+{
+    if (condition)
+        return true;
+    if (bench_failed_checks++ < BENCH_CHECK_REPORTS)
+    {
+        va_list args;
+        va_start(args, format);
+        fprintf(stderr, "FAIL: ");
+        vfprintf(stderr, format, args);
+        fprintf(stderr, "\n");
+        va_end(args);
+    }
+    return false;
+}
+
+int bench_failures(void)
+{
+    return bench_failed_checks;
+}
+
+void bench_parse_args(int argc, char **argv, bench_options_t *options)
+{
+    *options = (bench_options_t){.samples = BENCH_DEFAULT_SAMPLES, .batch = BENCH_DEFAULT_BATCH};
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            options->json = true;
+        else if (strcmp(argv[i], "--quick") == 0)
+            options->quick = true;
+        else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            options->samples = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            options->batch = (uint32_t)strtoul(argv[++i], NULL, 10);
+    }
+    if (options->quick)
+        options->samples = BENCH_QUICK_SAMPLES;
+    if (options->samples == 0)
+        options->samples = 1;
+    if (options->batch == 0)
+        options->batch = 1;
+}
+
+void bench_begin(const bench_options_t *options)
+{
+    bench_first_record = true;
+    if (options->json)
+        printf("[\n");
+    else
+        printf("primitive,params,calls_per_s,p50_ns,p90_ns,p99_ns\n");
+}
+
+void bench_end(const bench_options_t *options)
+{
+    if (options->json)
+        printf("\n]\n");
+    fflush(stdout);
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_percentile(const double *sorted, uint32_t total, uint32_t percent)
+{
+    uint32_t index = (uint32_t)(((uint64_t)total * percent + 99) / 100);
+    return sorted[index > 0 ? index - 1 : 0];
+}
+
+double bench_run(const bench_options_t *options, const char *primitive, const char *params, bench_fn_t fn, bench_fn_t setup, void *ctx)
+{
+    double *per_call = malloc(options->samples * sizeof(*per_call));
+    if (per_call == NULL)
+        return 0;
+
+    /* One untimed batch to warm the caches */
+    if (setup)
+        setup(ctx);
+    for (uint32_t j = 0; j < options->batch; j++)
+        fn(ctx);
+
+    uint64_t total_ns = 0;
+    for (uint32_t i = 0; i < options->samples; i++)
+    {
+        if (setup)
+            setup(ctx);
+        uint64_t start = bench_now_ns();
+        for (uint32_t j = 0; j < options->batch; j++)
+            fn(ctx);
+        uint64_t elapsed = bench_now_ns() - start;
+        total_ns += elapsed;
+        per_call[i] = (double)elapsed / options->batch;
+    }
+    qsort(per_call, options->samples, sizeof(*per_call), bench_compare);
+
+    double calls_per_s = total_ns ? 1e9 * options->samples * options->batch / total_ns : 0;
+    double p50 = bench_percentile(per_call, options->samples, 50);
+    double p90 = bench_percentile(per_call, options->samples, 90);
+    double p99 = bench_percentile(per_call, options->samples, 99);
+    if (options->json)
+    {
+        printf("%s  {\"primitive\": \"%s\", \"params\": \"%s\", \"calls_per_s\": %.0f, \"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f}",
+               bench_first_record ? "" : ",\n", primitive, params, calls_per_s, p50, p90, p99);
+    }
+    else
+    {
+        printf("%s,%s,%.0f,%.1f,%.1f,%.1f\n", primitive, params, calls_per_s, p50, p90, p99);
+    }
+    bench_first_record = false;
+    free(per_call);
+
+    return p50;
+}
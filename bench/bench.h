@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Host micro-benchmark helpers. A case is timed as 'samples' batches of 'batch' calls; the per-call time of every batch gives the
+   percentiles, the total gives the throughput. Results are printed as CSV (default) or as a JSON array with --json, one record per
+   case: primitive, parameters as "key=value;...", calls per second and p50/p90/p99 in nanoseconds per call. */
+
+typedef struct
+{
+    uint32_t samples;
+    uint32_t batch;
+    bool json;
+    bool quick;
+} bench_options_t;
+
+typedef void (*bench_fn_t)(void *ctx);
+
+/* Defaults, then --json, --quick (few samples, for a smoke test) and --samples N / --batch N from the command line. */
+void bench_parse_args(int argc, char **argv, bench_options_t *options);
+
+void bench_begin(const bench_options_t *options);
+void bench_end(const bench_options_t *options);
+
+/* Time fn(ctx) and print one record. 'setup', if not NULL, runs before every batch outside the timing. Returns the p50 in
+   nanoseconds per call. */
+double bench_run(const bench_options_t *options, const char *primitive, const char *params, bench_fn_t fn, bench_fn_t setup, void *ctx);
+
+/* Monotonic clock in nanoseconds */
+uint64_t bench_now_ns(void);
+
+/* Keeps the compiler from discarding a computed value */
+void bench_consume(uint64_t value);
+
+/* Host test helpers. A false 'condition' is counted as a failed check and, for the first BENCH_CHECK_REPORTS failures, the
+   printf-style message is printed to stderr. Returns 'condition'. */
+#define BENCH_CHECK_REPORTS 10
+bool bench_check(bool condition, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/* Failed checks so far */
+int bench_failures(void);
@@ -0,0 +1,246 @@
+/* DHT decoder test and benchmark - decodes synthetic traces shaped like the RMT captures, asserts the result of every fixture (ok,
+   no response, truncated, bad timing, checksum), sweeps the bit highs around the fixed 48 us threshold and random jitter, then
+   times dht_decode on a clean 40 bit trace. Exits with an error on the first failed assertion. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "dht_decode.h"
+
+#define MAX_PULSES 128
+#define JITTER_ROUNDS 5000
+
+typedef struct
+{
+    dht_pulse_t pulses[MAX_PULSES];
+    size_t total;
+} trace_t;
+
+/* Highs of the 0 and 1 bits, the lows of the bits, and the jitter added to every sensor pulse */
+typedef struct
+{
+    uint16_t zero_high_us;
+    uint16_t one_high_us;
+    uint16_t bit_low_us;
+    uint8_t jitter_us;
+    bool glitches;
+} trace_shape_t;
+
+static const trace_shape_t nominal = {.zero_high_us = 26, .one_high_us = 70, .bit_low_us = 50};
+
+/* 45.6 %RH, 23.4 C in the DHT22 format */
+static const uint8_t reading[DHT_DECODE_DATA_BYTES] = {0x01, 0xC8, 0x00, 0xEA, 0xB3};
+
+static uint32_t random_state = 0x9E3779B9;
+
+static uint32_t next_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+static uint16_t jitter(const trace_shape_t *shape, uint16_t duration_us)
+{
+    if (shape->jitter_us == 0)
+        return duration_us;
+    return duration_us + (int)(next_random() % (2u * shape->jitter_us + 1)) - shape->jitter_us;
+}
+
+static void add_pulse(trace_t *trace, uint8_t level, uint16_t duration_us)
+{
+    if (trace->total < MAX_PULSES)
+        trace->pulses[trace->total++] = (dht_pulse_t){.level = level, .duration_us = duration_us};
+}
+
+/* Tail of the host start pulse, host release, sensor response, 40 bits, the sensor's final low and the end marker */
+static void build_trace(trace_t *trace, const uint8_t data[DHT_DECODE_DATA_BYTES], const trace_shape_t *shape)
+{
+    trace->total = 0;
+    add_pulse(trace, 0, 3);
+    add_pulse(trace, 1, jitter(shape, 30));
+    add_pulse(trace, 0, jitter(shape, 80));
+    add_pulse(trace, 1, jitter(shape, 80));
+    for (uint8_t bit = 0; bit < 40; bit++)
+    {
+        bool one = (data[bit / 8] >> (7 - bit % 8)) & 1;
+        uint16_t low = jitter(shape, shape->bit_low_us);
+        if (shape->glitches && next_random() % 10 == 0)
+        {
+            /* A spike of 1-3 us inside the low, to be merged back by the decoder */
+            uint16_t before = low / 2;
+            add_pulse(trace, 0, before);
+            add_pulse(trace, 1, 1 + next_random() % 3);
+            add_pulse(trace, 0, low - before);
+        }
+        else
+        {
+            add_pulse(trace, 0, low);
+        }
+        add_pulse(trace, 1, jitter(shape, one ? shape->one_high_us : shape->zero_high_us));
+    }
+    add_pulse(trace, 0, 50);
+    add_pulse(trace, 1, 0);
+}
+
+/* Index of the high pulse of a bit in a trace built without glitches */
+static size_t bit_high(uint8_t bit)
+{
+    return 4 + bit * 2 + 1;
+}
+
+static void expect(const char *name, const trace_t *trace, dht_decode_result_t expected, const uint8_t *expected_data)
+{
+    uint8_t data[DHT_DECODE_DATA_BYTES];
+    dht_decode_result_t result = dht_decode(trace->pulses, trace->total, data);
+    bool data_ok = expected_data == NULL || memcmp(data, expected_data, sizeof(data)) == 0;
+    printf("%-34s %-18s %s\n", name, dht_decode_result_name(result), result == expected && data_ok ? "pass" : "FAIL");
+    bench_check(result == expected && data_ok, "%s: expected %s, got %s%s", name, dht_decode_result_name(expected),
+                dht_decode_result_name(result), data_ok ? "" : " with wrong data");
+}
+
+static void check_fixtures(void)
+{
+    trace_t trace;
+    trace_shape_t shape = nominal;
+
+    build_trace(&trace, reading, &nominal);
+    expect("clean", &trace, DHT_DECODE_OK, reading);
+
+    shape.glitches = true;
+    build_trace(&trace, reading, &shape);
+    expect("glitches inside the bit lows", &trace, DHT_DECODE_OK, reading);
+
+    trace.total = 0;
+    expect("empty capture", &trace, DHT_DECODE_NO_RESPONSE, NULL);
+
+    trace.total = 0;
+    add_pulse(&trace, 0, 3);
+    add_pulse(&trace, 1, 30);
+    add_pulse(&trace, 0, 0);
+    expect("host release only", &trace, DHT_DECODE_NO_RESPONSE, NULL);
+
+    build_trace(&trace, reading, &nominal);
+    trace.pulses[2].duration_us = 40;
+    expect("response low too short", &trace, DHT_DECODE_NO_RESPONSE, NULL);
+
+    build_trace(&trace, reading, &nominal);
+    trace.total = bit_high(19) + 1;
+    expect("capture ends after 20 bits", &trace, DHT_DECODE_TRUNCATED, NULL);
+
+    build_trace(&trace, reading, &nominal);
+    trace.pulses[bit_high(39)].duration_us = 0;
+    expect("end marker in the last bit", &trace, DHT_DECODE_TRUNCATED, NULL);
+
+    build_trace(&trace, reading, &nominal);
+    trace.pulses[bit_high(10) - 1].duration_us = 150;
+    expect("bit low too long", &trace, DHT_DECODE_BAD_TIMING, NULL);
+
+    build_trace(&trace, reading, &nominal);
+    trace.pulses[bit_high(10) - 1].duration_us = 10;
+    expect("bit low too short", &trace, DHT_DECODE_BAD_TIMING, NULL);
+
+    build_trace(&trace, reading, &nominal);
+    trace.pulses[bit_high(25)].duration_us = 130;
+    expect("bit high too long", &trace, DHT_DECODE_BAD_TIMING, NULL);
+
+    uint8_t corrupted[DHT_DECODE_DATA_BYTES];
+    memcpy(corrupted, reading, sizeof(corrupted));
+    corrupted[3] ^= 0x04;
+    build_trace(&trace, corrupted, &nominal);
+    expect("one data bit flipped", &trace, DHT_DECODE_CHECKSUM, NULL);
+}
+
+/* Highs on both sides of the threshold: 47 us still reads 0 and 48 us already reads 1 */
+static void check_threshold(void)
+{
+    static const uint8_t pattern[DHT_DECODE_DATA_BYTES] = {0xA5, 0x5A, 0x0F, 0xF0, 0xFE};
+    trace_t trace;
+    trace_shape_t shape = nominal;
+
+    shape.zero_high_us = DHT_DECODE_BIT_ONE_MIN_US - 1;
+    shape.one_high_us = DHT_DECODE_BIT_ONE_MIN_US;
+    build_trace(&trace, pattern, &shape);
+    expect("highs of 47 and 48 us", &trace, DHT_DECODE_OK, pattern);
+
+    /* Every bit reads 1: the sum of four 0xFF bytes is 0xFC, not 0xFF */
+    shape.zero_high_us = DHT_DECODE_BIT_ONE_MIN_US;
+    build_trace(&trace, pattern, &shape);
+    expect("0 bits stretched to 48 us", &trace, DHT_DECODE_CHECKSUM, NULL);
+
+    /* Every bit reads 0, an all-zero frame that the checksum cannot tell from a real one */
+    static const uint8_t zeros[DHT_DECODE_DATA_BYTES] = {0};
+    shape.zero_high_us = nominal.zero_high_us;
+    shape.one_high_us = DHT_DECODE_BIT_ONE_MIN_US - 1;
+    build_trace(&trace, pattern, &shape);
+    expect("1 bits shrunk to 47 us", &trace, DHT_DECODE_OK, zeros);
+}
+
+/* Random jitter on every pulse, with glitches. The nominal pulses are at least 20 us from every limit (the 60 us response minimum
+   is the tightest, the bit threshold leaves 21 and 22 us), so every reading must decode up to +-20 us, and the success rate is
+   reported beyond that. */
+#define JITTER_MARGIN_US 20
+
+static void check_jitter(void)
+{
+    printf("\njitter_us,decoded,rounds\n");
+    for (uint8_t jitter_us = 0; jitter_us <= 30; jitter_us += 2)
+    {
+        trace_shape_t shape = nominal;
+        shape.jitter_us = jitter_us;
+        shape.glitches = true;
+        uint32_t decoded = 0;
+        for (uint32_t round = 0; round < JITTER_ROUNDS; round++)
+        {
+            uint8_t data[DHT_DECODE_DATA_BYTES];
+            uint8_t expected[DHT_DECODE_DATA_BYTES];
+            trace_t trace;
+            for (uint8_t i = 0; i < 4; i++)
+                expected[i] = (uint8_t)next_random();
+            expected[4] = (uint8_t)(expected[0] + expected[1] + expected[2] + expected[3]);
+            build_trace(&trace, expected, &shape);
+            decoded += dht_decode(trace.pulses, trace.total, data) == DHT_DECODE_OK && memcmp(data, expected, sizeof(data)) == 0;
+        }
+        printf("%u,%lu,%u\n", jitter_us, (unsigned long)decoded, JITTER_ROUNDS);
+        bench_check(jitter_us > JITTER_MARGIN_US || decoded == JITTER_ROUNDS, "jitter +-%u us: only %lu of %u readings decoded", jitter_us,
+                    (unsigned long)decoded, JITTER_ROUNDS);
+    }
+    printf("\n");
+}
+
+static trace_t bench_trace;
+
+static void run_decode(void *ctx)
+{
+    (void)ctx;
+    uint8_t data[DHT_DECODE_DATA_BYTES];
+    bench_consume(dht_decode(bench_trace.pulses, bench_trace.total, data) + data[4]);
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t options;
+    bench_parse_args(argc, argv, &options);
+
+    check_fixtures();
+    check_threshold();
+    check_jitter();
+    if (bench_failures())
+    {
+        fprintf(stderr, "%d checks failed\n", bench_failures());
+        return 1;
+    }
+
+    bench_begin(&options);
+    build_trace(&bench_trace, reading, &nominal);
+    bench_run(&options, "dht_decode", "bits=40;glitches=0", run_decode, NULL, NULL);
+    trace_shape_t shape = nominal;
+    shape.glitches = true;
+    build_trace(&bench_trace, reading, &shape);
+    bench_run(&options, "dht_decode", "bits=40;glitches=10%", run_decode, NULL, NULL);
+    bench_end(&options);
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+/* Number formatting test and benchmark - compares num_format with snprintf on random values and formats (width, zero padding,
+   plus sign, 0-9 decimals, prefix and unit, output sizes down to 1 byte), plus the edge cases INT32_MIN, zero width, truncation
+   and negative values below one, then times num_format against the snprintf calls it replaced. Exits with an error on the first
+   mismatch. */
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "num_format.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define RANDOM_ROUNDS 1000000
+#define TEXT_SIZE 48
+
+static uint32_t random_state = 0x1234567;
+
+static uint32_t next_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+static const int32_t powers_of_ten[NUM_FORMAT_MAX_DECIMALS + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/* snprintf reference. Every int32_t divided by a power of ten is within far less than half a unit of the last printed decimal as
+   a double, so "%.*f" prints the exact value. */
+static void reference_format(char *text, size_t size, int32_t value, const num_format_t *format)
+{
+    uint8_t decimals = format->decimals < NUM_FORMAT_MAX_DECIMALS ? format->decimals : NUM_FORMAT_MAX_DECIMALS;
+    char spec[16];
+    snprintf(spec, sizeof(spec), "%%s%%%s%s*.*f%%s", format->plus && value > 0 ? "+" : "", format->zero_pad ? "0" : "");
+    snprintf(text, size, spec, format->prefix ? format->prefix : "", format->width, decimals, (double)value / powers_of_ten[decimals],
+             format->unit ? format->unit : "");
+}
+
+static void compare(int32_t value, const num_format_t *format, size_t size)
+{
+    char text[TEXT_SIZE];
+    char expected[TEXT_SIZE];
+    reference_format(expected, size, value, format);
+    size_t length = num_format(text, size, value, format);
+    bench_check(strcmp(text, expected) == 0 && length == strlen(text),
+                "value=%ld decimals=%u width=%u zero_pad=%d plus=%d size=%u: got \"%s\" (%u), expected \"%s\"", (long)value,
+                format->decimals, format->width, format->zero_pad, format->plus, (unsigned)size, text, (unsigned)length, expected);
+}
+
+static void check_edge_cases(void)
+{
+    static const int32_t values[] = {INT32_MIN, INT32_MIN + 1, INT32_MAX, 0, 1, -1, 5, -5, 9, -9, 10, -10, -99, -100, 999999999, -1000000000};
+    static const char *const affixes[] = {NULL, "", "(", "\xC2\xB0"};
+    for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++)
+        for (uint8_t decimals = 0; decimals <= NUM_FORMAT_MAX_DECIMALS; decimals++)
+            for (uint8_t width = 0; width <= 16; width++)
+                for (uint8_t flags = 0; flags < 4; flags++)
+                    for (size_t a = 0; a < sizeof(affixes) / sizeof(affixes[0]); a++)
+                    {
+                        num_format_t format = {.decimals = decimals, .width = width, .zero_pad = flags & 1, .plus = flags & 2,
+                                               .prefix = affixes[a], .unit = affixes[(a + 1) % 4]};
+                        for (size_t size = 1; size <= TEXT_SIZE; size++)
+                            compare(values[v], &format, size);
+                    }
+
+    /* NULL format is a plain integer, decimals above the maximum are clamped, nothing is written with size 0 */
+    char text[TEXT_SIZE] = "untouched";
+    num_format(text, sizeof(text), INT32_MIN, NULL);
+    bench_check(strcmp(text, "-2147483648") == 0, "INT32_MIN without a format gave \"%s\"", text);
+    char clamped[TEXT_SIZE];
+    num_format(text, sizeof(text), -123, &(num_format_t){.decimals = 12});
+    num_format(clamped, sizeof(clamped), -123, &(num_format_t){.decimals = NUM_FORMAT_MAX_DECIMALS});
+    bench_check(strcmp(text, clamped) == 0, "12 decimals gave \"%s\", expected the %d decimal \"%s\"", text, NUM_FORMAT_MAX_DECIMALS, clamped);
+    strcpy(text, "untouched");
+    bench_check(num_format(text, 0, 42, NULL) == 0 && strcmp(text, "untouched") == 0, "size 0 wrote to the buffer");
+}
+
+static void check_random(void)
+{
+    static const char *const affixes[] = {NULL, "(", ")", " %", "\xC2\xB0", "Temp: "};
+    for (uint32_t round = 0; round < RANDOM_ROUNDS; round++)
+    {
+        /* Half of the values small, where the leading zero and sign handling lives */
+        int32_t value = (next_random() & 1) ? (int32_t)next_random() : (int32_t)(next_random() % 2001) - 1000;
+        uint32_t bits = next_random();
+        num_format_t format = {.decimals = bits % (NUM_FORMAT_MAX_DECIMALS + 1), .width = (bits >> 4) % 20, .zero_pad = (bits >> 9) & 1,
+                               .plus = (bits >> 10) & 1, .prefix = affixes[(bits >> 11) % 6], .unit = affixes[(bits >> 14) % 6]};
+        compare(value, &format, 1 + (bits >> 17) % TEXT_SIZE);
+    }
+}
+
+typedef struct
+{
+    int32_t values[1024];
+    uint32_t next;
+    char text[TEXT_SIZE];
+} format_case_t;
+
+static const num_format_t temperature_format = {.decimals = 1, .unit = "\xC2\xB0"};
+
+static void run_num_format_tenths(void *ctx)
+{
+    format_case_t *c = ctx;
+    bench_consume(num_format(c->text, sizeof(c->text), c->values[c->next++ & 1023], &temperature_format));
+}
+
+static void run_snprintf_float(void *ctx)
+{
+    format_case_t *c = ctx;
+    bench_consume(snprintf(c->text, sizeof(c->text), "%.1f\xC2\xB0", c->values[c->next++ & 1023] / 10.0f));
+}
+
+static void run_num_format_int(void *ctx)
+{
+    format_case_t *c = ctx;
+    bench_consume(num_format(c->text, sizeof(c->text), c->values[c->next++ & 1023], NULL));
+}
+
+static void run_snprintf_int(void *ctx)
+{
+    format_case_t *c = ctx;
+    bench_consume(snprintf(c->text, sizeof(c->text), "%d", (int)c->values[c->next++ & 1023]));
+}
+
+/* TSC ticks per nanosecond, to also show the times as cycles on x86 hosts */
+static double tsc_per_ns(void)
+{
+#ifdef HAVE_TSC
+    uint64_t start_ns = bench_now_ns();
+    uint64_t start_tsc = __rdtsc();
+    while (bench_now_ns() - start_ns < 20000000)
+        ;
+    return (double)(__rdtsc() - start_tsc) / (bench_now_ns() - start_ns);
+#else
+    return 0;
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t options;
+    bench_parse_args(argc, argv, &options);
+
+    check_edge_cases();
+    check_random();
+    if (bench_failures())
+    {
+        fprintf(stderr, "%d mismatches against snprintf\n", bench_failures());
+        return 1;
+    }
+    fprintf(stderr, "Equivalence: edge cases and %u random formats match snprintf\n", RANDOM_ROUNDS);
+
+    /* Temperatures from -10.0 to 59.9 */
+    static format_case_t c;
+    for (size_t i = 0; i < sizeof(c.values) / sizeof(c.values[0]); i++)
+        c.values[i] = (int32_t)(next_random() % 700) - 100;
+
+    bench_begin(&options);
+    double tenths = bench_run(&options, "num_format", "decimals=1;unit=deg", run_num_format_tenths, NULL, &c);
+    double tenths_snprintf = bench_run(&options, "snprintf", "format=%.1f;unit=deg", run_snprintf_float, NULL, &c);
+    double integer = bench_run(&options, "num_format", "decimals=0", run_num_format_int, NULL, &c);
+    double integer_snprintf = bench_run(&options, "snprintf", "format=%d", run_snprintf_int, NULL, &c);
+    bench_end(&options);
+
+    double cycles = tsc_per_ns();
+    fprintf(stderr, "tenths:  num_format %.1f ns (%.0f cycles), snprintf(\"%%.1f\") %.1f ns (%.0f cycles), %.1fx\n", tenths, tenths * cycles,
+            tenths_snprintf, tenths_snprintf * cycles, tenths > 0 ? tenths_snprintf / tenths : 0);
+    fprintf(stderr, "integer: num_format %.1f ns (%.0f cycles), snprintf(\"%%d\") %.1f ns (%.0f cycles), %.1fx\n", integer, integer * cycles,
+            integer_snprintf, integer_snprintf * cycles, integer > 0 ? integer_snprintf / integer : 0);
+
+    return 0;
+}
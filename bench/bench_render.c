@@ -0,0 +1,123 @@
+/* Rendering primitives benchmark - times i2c_ssd1306_buffer_text, _image, _fill_space and _clear on a 128x64 panel backed by the
+   in-memory transport, over a matrix of positions, sizes and row alignments. This is the baseline a rendering change has to beat. */
+
+#include <stdio.h>
+#include "bench.h"
+#include "esp_log.h"
+#include "ssd1306.h"
+
+typedef struct
+{
+    i2c_ssd1306_handle_t *display;
+    uint8_t x;
+    uint8_t y;
+    uint8_t width;
+    uint8_t height;
+    const char *text;
+    const uint8_t *image;
+} render_case_t;
+
+static ssd1306_ram_t ram;
+static i2c_ssd1306_handle_t display;
+static uint8_t image[64 * 64 / 8];
+
+static void clear_frame(void *ctx)
+{
+    i2c_ssd1306_buffer_clear(((render_case_t *)ctx)->display);
+}
+
+static void run_text(void *ctx)
+{
+    render_case_t *c = ctx;
+    i2c_ssd1306_buffer_text(c->display, c->x, c->y, c->text, false);
+}
+
+static void run_image(void *ctx)
+{
+    render_case_t *c = ctx;
+    i2c_ssd1306_buffer_image(c->display, c->x, c->y, c->image, c->width, c->height, false);
+}
+
+static void run_fill_space(void *ctx)
+{
+    render_case_t *c = ctx;
+    i2c_ssd1306_buffer_fill_space(c->display, c->x, c->x + c->width - 1, c->y, c->y + c->height - 1, true);
+}
+
+static void run_clear(void *ctx)
+{
+    i2c_ssd1306_buffer_clear(((render_case_t *)ctx)->display);
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t options;
+    bench_parse_args(argc, argv, &options);
+    host_log_level = ESP_LOG_NONE;
+
+    ssd1306_transport_t transport;
+    i2c_ssd1306_config_t config = {.width = 128, .height = 64, .wise = SSD1306_TOP_TO_BOTTOM, .addr_mode = SSD1306_ADDR_MODE_HORIZONTAL};
+    if (ssd1306_ram_transport_init(&ram, config.width, config.height, &transport) != ESP_OK ||
+        i2c_ssd1306_init_transport(transport, config, &display) != ESP_OK)
+    {
+        fprintf(stderr, "Failed to initialize the in-memory display\n");
+        return 1;
+    }
+    for (size_t i = 0; i < sizeof(image); i++)
+        image[i] = (uint8_t)(i * 37 + 11);
+
+    static const char *const texts[] = {"8", "22.5\xC2\xB0", "Temperatura 22.5"};
+    static const uint8_t text_x[] = {0, 5};
+    static const uint8_t rows[] = {16, 17, 20, 23};
+    static const uint8_t image_sizes[][2] = {{8, 8}, {32, 32}, {64, 64}};
+    static const uint8_t image_positions[][2] = {{0, 0}, {3, 0}, {0, 3}};
+    static const uint8_t fill_sizes[][2] = {{1, 1}, {8, 8}, {32, 16}, {128, 64}};
+    static const uint8_t fill_rows[] = {0, 3};
+
+    char params[96];
+    render_case_t c = {.display = &display};
+    bench_begin(&options);
+
+    for (size_t t = 0; t < sizeof(texts) / sizeof(texts[0]); t++)
+        for (size_t i = 0; i < sizeof(text_x); i++)
+            for (size_t j = 0; j < sizeof(rows); j++)
+            {
+                c.x = text_x[i];
+                c.y = rows[j];
+                c.text = texts[t];
+                snprintf(params, sizeof(params), "x=%u;y=%u;chars=%u;align=%s", c.x, c.y, (unsigned)(t == 0 ? 1 : t == 1 ? 5 : 16),
+                         c.y % 8 == 0 ? "page" : "unaligned");
+                bench_run(&options, "buffer_text", params, run_text, clear_frame, &c);
+            }
+
+    c.image = image;
+    for (size_t s = 0; s < sizeof(image_sizes) / sizeof(image_sizes[0]); s++)
+        for (size_t p = 0; p < sizeof(image_positions) / sizeof(image_positions[0]); p++)
+        {
+            c.width = image_sizes[s][0];
+            c.height = image_sizes[s][1];
+            c.x = image_positions[p][0];
+            c.y = image_positions[p][1];
+            snprintf(params, sizeof(params), "x=%u;y=%u;size=%ux%u;align=%s", c.x, c.y, c.width, c.height, c.y % 8 == 0 ? "page" : "unaligned");
+            bench_run(&options, "buffer_image", params, run_image, clear_frame, &c);
+        }
+
+    for (size_t s = 0; s < sizeof(fill_sizes) / sizeof(fill_sizes[0]); s++)
+        for (size_t r = 0; r < sizeof(fill_rows); r++)
+        {
+            c.x = 0;
+            c.width = fill_sizes[s][0];
+            c.height = fill_sizes[s][1];
+            c.y = fill_rows[r];
+            if (c.y + c.height > config.height)
+                c.height = config.height - c.y;
+            snprintf(params, sizeof(params), "x=%u;y=%u;size=%ux%u;align=%s", c.x, c.y, c.width, c.height, c.y % 8 == 0 ? "page" : "unaligned");
+            bench_run(&options, "buffer_fill_space", params, run_fill_space, NULL, &c);
+        }
+
+    snprintf(params, sizeof(params), "size=%ux%u", config.width, config.height);
+    bench_run(&options, "buffer_clear", params, run_clear, NULL, &c);
+
+    bench_end(&options);
+    return 0;
+}
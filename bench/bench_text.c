@@ -0,0 +1,226 @@
+/* Text blit benchmark - checks that i2c_ssd1306_buffer_text draws exactly what the previous column-by-column renderer drew, at
+   every row offset 0-7, with random strings, positions, inversion and clipping, then times both in nanoseconds per character on
+   page aligned and unaligned rows. Exits with an error on the first mismatch. */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "esp_log.h"
+#include "ssd1306.h"
+
+#define EQUIVALENCE_ROUNDS 20000
+
+typedef struct
+{
+    i2c_ssd1306_handle_t *display;
+    uint8_t x;
+    uint8_t y;
+    const char *text;
+} text_case_t;
+
+static ssd1306_ram_t ram;
+static i2c_ssd1306_handle_t display;
+static i2c_ssd1306_handle_t reference;
+static uint32_t random_state = 0x2545F491;
+
+static uint32_t next_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+/* Same decoding and lookup as the driver: one and two byte UTF-8, ranges, fallback glyph */
+static uint16_t reference_glyph_index(const ssd1306_font_t *font, const char **text)
+{
+    const uint8_t *c = (const uint8_t *)*text;
+    uint16_t code_point;
+    if (c[0] >= 0xC2 && c[0] <= 0xDF && (c[1] & 0xC0) == 0x80)
+    {
+        code_point = ((c[0] & 0x1F) << 6) | (c[1] & 0x3F);
+        *text += 2;
+    }
+    else
+    {
+        code_point = c[0] < 0x80 ? c[0] : 0xFFFF;
+        *text += 1;
+    }
+    for (uint8_t i = 0; i < font->total_ranges; i++)
+    {
+        if (code_point >= font->ranges[i].first && code_point <= font->ranges[i].last)
+            return font->ranges[i].glyph_index + (code_point - font->ranges[i].first);
+    }
+
+    return font->fallback;
+}
+
+/* The renderer before the word blit: one column byte at a time, split into two pages on unaligned rows. Updated for the sparse
+   proportional font only in the glyph lookup and advance. */
+static esp_err_t reference_text(i2c_ssd1306_handle_t *target, uint8_t x, uint8_t y, const char *text, bool invert)
+{
+    if (x >= target->width || y >= target->height || !text || text[0] == '\0')
+        return ESP_ERR_INVALID_ARG;
+
+    const ssd1306_font_t *font = target->font;
+    uint8_t page = y / 8;
+    uint8_t offset = y % 8;
+    bool has_next_page = (page + 1) < target->total_pages;
+    const char *c = text;
+    while (*c != '\0' && x < target->width)
+    {
+        uint16_t glyph_index = reference_glyph_index(font, &c);
+        uint8_t advance = font->advance ? font->advance[glyph_index] : font->width;
+        for (uint8_t j = 0; j < advance && x + j < target->width; j++)
+        {
+            uint8_t char_col = invert ? ~font->glyphs[glyph_index][j] : font->glyphs[glyph_index][j];
+            if (offset == 0)
+            {
+                target->page[page].segment[x + j] |= char_col;
+            }
+            else
+            {
+                target->page[page].segment[x + j] |= char_col << offset;
+                if (has_next_page)
+                    target->page[page + 1].segment[x + j] |= char_col >> (8 - offset);
+            }
+        }
+        x = (x + advance < target->width) ? x + advance : target->width;
+    }
+
+    return ESP_OK;
+}
+
+static bool buffers_equal(void)
+{
+    for (uint8_t page = 0; page < display.total_pages; page++)
+    {
+        if (memcmp(display.page[page].segment, reference.page[page].segment, display.width) != 0)
+            return false;
+    }
+    return true;
+}
+
+static void random_text(char *text, size_t size)
+{
+    static const char *const pieces[] = {"0", "7", "-", ".", " ", "A", "z", "%", "(", ")", "\xC2\xB0", "\xC3\xB1", "\xC3\xA1",
+                                         "\xE2\x82\xAC", "\x80", "~"};
+    size_t length = 0;
+    uint32_t total = 1 + next_random() % 24;
+    text[0] = '\0';
+    for (uint32_t i = 0; i < total; i++)
+    {
+        const char *piece = pieces[next_random() % (sizeof(pieces) / sizeof(pieces[0]))];
+        size_t piece_length = strlen(piece);
+        if (length + piece_length >= size)
+            break;
+        memcpy(text + length, piece, piece_length + 1);
+        length += piece_length;
+    }
+}
+
+static int check_equivalence(void)
+{
+    char text[64];
+    for (uint32_t round = 0; round < EQUIVALENCE_ROUNDS; round++)
+    {
+        /* Every offset 0-7 on every page, the last one included where the lower half is cut off */
+        uint8_t offset = round % 8;
+        uint8_t y = (uint8_t)((next_random() % display.total_pages) * 8 + offset);
+        uint8_t x = (uint8_t)(next_random() % display.width);
+        bool invert = next_random() & 1;
+        random_text(text, sizeof(text));
+
+        /* Draw over a shared random background, so that the OR into existing pixels is compared too */
+        for (uint8_t page = 0; page < display.total_pages; page++)
+            for (uint8_t segment = 0; segment < display.width; segment++)
+                display.page[page].segment[segment] = reference.page[page].segment[segment] = (next_random() & 0x11) ? 0 : (uint8_t)next_random();
+
+        esp_err_t err = i2c_ssd1306_buffer_text(&display, x, y, text, invert);
+        esp_err_t expected = reference_text(&reference, x, y, text, invert);
+        if (err != expected || !buffers_equal())
+        {
+            fprintf(stderr, "Mismatch at x=%u y=%u (offset %u) invert=%d text=\"%s\"\n", x, y, offset, invert, text);
+            return 1;
+        }
+    }
+    fprintf(stderr, "Equivalence: %u random strings match the column renderer at offsets 0-7\n", EQUIVALENCE_ROUNDS);
+
+    return 0;
+}
+
+static void clear_frame(void *ctx)
+{
+    i2c_ssd1306_buffer_clear(((text_case_t *)ctx)->display);
+}
+
+static void run_blit(void *ctx)
+{
+    text_case_t *c = ctx;
+    i2c_ssd1306_buffer_text(c->display, c->x, c->y, c->text, false);
+}
+
+static void run_reference(void *ctx)
+{
+    text_case_t *c = ctx;
+    reference_text(c->display, c->x, c->y, c->text, false);
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t options;
+    bench_parse_args(argc, argv, &options);
+    host_log_level = ESP_LOG_NONE;
+
+    ssd1306_transport_t transport;
+    i2c_ssd1306_config_t config = {.width = 128, .height = 64, .wise = SSD1306_TOP_TO_BOTTOM, .addr_mode = SSD1306_ADDR_MODE_HORIZONTAL};
+    if (ssd1306_ram_transport_init(&ram, config.width, config.height, &transport) != ESP_OK ||
+        i2c_ssd1306_init_transport(transport, config, &display) != ESP_OK)
+    {
+        fprintf(stderr, "Failed to initialize the in-memory display\n");
+        return 1;
+    }
+    /* The reference only draws into its own buffer, nothing is flushed */
+    if (i2c_ssd1306_init_transport(transport, config, &reference) != ESP_OK)
+    {
+        fprintf(stderr, "Failed to initialize the reference buffer\n");
+        return 1;
+    }
+
+    if (check_equivalence() != 0)
+        return 1;
+
+    /* 16 glyphs that fit the width from x=0 */
+    static const char text[] = "Temperatura 22.5";
+    static const uint8_t rows[] = {16, 17, 20, 23};
+    const uint32_t chars = sizeof(text) - 1;
+    double blit_ns[2] = {0};
+    double reference_ns[2] = {0};
+    uint32_t counts[2] = {0};
+
+    char params[64];
+    text_case_t c = {.display = &display, .x = 0, .text = text};
+    bench_begin(&options);
+    for (size_t i = 0; i < sizeof(rows); i++)
+    {
+        c.y = rows[i];
+        bool aligned = c.y % 8 == 0;
+        snprintf(params, sizeof(params), "y=%u;chars=%u;align=%s", c.y, (unsigned)chars, aligned ? "page" : "unaligned");
+        blit_ns[aligned] += bench_run(&options, "text_blit", params, run_blit, clear_frame, &c) / chars;
+        reference_ns[aligned] += bench_run(&options, "text_reference", params, run_reference, clear_frame, &c) / chars;
+        counts[aligned]++;
+    }
+    bench_end(&options);
+
+    for (int aligned = 1; aligned >= 0; aligned--)
+    {
+        if (counts[aligned] == 0)
+            continue;
+        double blit = blit_ns[aligned] / counts[aligned];
+        double column = reference_ns[aligned] / counts[aligned];
+        fprintf(stderr, "%-9s rows: blit %.1f ns/char, column renderer %.1f ns/char, %.2fx\n", aligned ? "aligned" : "unaligned", blit, column,
+                blit > 0 ? column / blit : 0);
+    }
+
+    return 0;
+}
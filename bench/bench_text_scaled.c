@@ -0,0 +1,133 @@
+/* Scaled text benchmark - checks that the scaled glyph cache keeps the whole temperature readout: drawing "20.5°" at scale 3 a
+   second time must expand no glyph and draw the same pixels, even though '0' and '°' share a slot under a direct-mapped cache. Also
+   checks that text clipped to a region draws nothing past it. Then times the readout at scales 1-3 with the cache warm. Exits with
+   an error if a check fails. */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "esp_log.h"
+#include "ssd1306.h"
+
+typedef struct
+{
+    i2c_ssd1306_handle_t *display;
+    uint8_t scale;
+    const char *text;
+} scaled_case_t;
+
+static ssd1306_ram_t ram;
+static i2c_ssd1306_handle_t display;
+static uint8_t first_pass[SSD1306_MAX_PAGES][SSD1306_MAX_WIDTH];
+
+static const char readout[] = "20.5\xC2\xB0";
+
+static int check_readout_cached(void)
+{
+    i2c_ssd1306_buffer_clear(&display);
+    if (i2c_ssd1306_buffer_text_scaled(&display, 0, 16, readout, 3, false) != ESP_OK)
+    {
+        fprintf(stderr, "Failed to draw the readout\n");
+        return 1;
+    }
+    uint32_t first_misses = display.glyph_cache_misses;
+    for (uint8_t page = 0; page < display.total_pages; page++)
+        memcpy(first_pass[page], display.page[page].segment, display.width);
+
+    i2c_ssd1306_buffer_clear(&display);
+    i2c_ssd1306_buffer_text_scaled(&display, 0, 16, readout, 3, false);
+    uint32_t second_misses = display.glyph_cache_misses - first_misses;
+    if (second_misses != 0)
+    {
+        fprintf(stderr, "Second pass of \"%s\" expanded %u glyphs, expected none\n", readout, (unsigned)second_misses);
+        return 1;
+    }
+    for (uint8_t page = 0; page < display.total_pages; page++)
+    {
+        if (memcmp(first_pass[page], display.page[page].segment, display.width) != 0)
+        {
+            fprintf(stderr, "Second pass of \"%s\" differs from the first on page %u\n", readout, page);
+            return 1;
+        }
+    }
+    fprintf(stderr, "Cache: \"%s\" at scale 3 expanded %u glyphs once, none on the second pass\n", readout, (unsigned)first_misses);
+
+    return 0;
+}
+
+static int check_clipped(void)
+{
+    /* Wider than its region at scale 3, like a negative temperature in a narrow widget */
+    static const uint8_t x = 10;
+    static const uint8_t width = 40;
+    i2c_ssd1306_buffer_clear(&display);
+    if (i2c_ssd1306_buffer_text_clipped(&display, x, 16, "-10.5\xC2\xB0", 3, width, false) != ESP_OK)
+    {
+        fprintf(stderr, "Failed to draw the clipped text\n");
+        return 1;
+    }
+    bool inside = false;
+    for (uint8_t page = 0; page < display.total_pages; page++)
+        for (uint8_t segment = 0; segment < display.width; segment++)
+        {
+            if (segment >= x && segment < x + width)
+            {
+                inside |= display.page[page].segment[segment] != 0;
+            }
+            else if (display.page[page].segment[segment] != 0)
+            {
+                fprintf(stderr, "Clipped text drew column %u on page %u, outside %u-%u\n", segment, page, x, x + width - 1);
+                return 1;
+            }
+        }
+    if (!inside)
+    {
+        fprintf(stderr, "Clipped text drew nothing inside its region\n");
+        return 1;
+    }
+    fprintf(stderr, "Clip: text clipped to columns %u-%u stays inside them\n", x, x + width - 1);
+
+    return 0;
+}
+
+static void clear_frame(void *ctx)
+{
+    i2c_ssd1306_buffer_clear(((scaled_case_t *)ctx)->display);
+}
+
+static void run_scaled(void *ctx)
+{
+    scaled_case_t *c = ctx;
+    i2c_ssd1306_buffer_text_scaled(c->display, 0, 16, c->text, c->scale, false);
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t options;
+    bench_parse_args(argc, argv, &options);
+    host_log_level = ESP_LOG_NONE;
+
+    ssd1306_transport_t transport;
+    i2c_ssd1306_config_t config = {.width = 128, .height = 64, .wise = SSD1306_TOP_TO_BOTTOM, .addr_mode = SSD1306_ADDR_MODE_HORIZONTAL};
+    if (ssd1306_ram_transport_init(&ram, config.width, config.height, &transport) != ESP_OK ||
+        i2c_ssd1306_init_transport(transport, config, &display) != ESP_OK)
+    {
+        fprintf(stderr, "Failed to initialize the in-memory display\n");
+        return 1;
+    }
+
+    if (check_readout_cached() != 0 || check_clipped() != 0)
+        return 1;
+
+    char params[64];
+    scaled_case_t c = {.display = &display, .text = readout};
+    bench_begin(&options);
+    for (c.scale = 1; c.scale <= SSD1306_TEXT_MAX_SCALE; c.scale++)
+    {
+        snprintf(params, sizeof(params), "text=20.5deg;scale=%u", c.scale);
+        bench_run(&options, "buffer_text_scaled", params, run_scaled, clear_frame, &c);
+    }
+    bench_end(&options);
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+/* Frame capture - renders the firmware screens with the real i2c_ssd1306_buffer_* code, flushes them through the in-memory
+   transport (full flush, then the shadow GDDRAM diff path from one screen to the next) and writes what the controller holds as PBM
+   images. Each capture is checked against the handle's buffer and against the reference images in bench/frames/. Also checks that
+   no frame is transferred while the display scrolls.
+
+   Usage: render_frames <output dir> [<reference dir>] [--update]
+   --update rewrites the reference images instead of comparing with them. */
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "ssd1306.h"
+#include "num_format.h"
+#include "translations.h"
+
+extern uint8_t ssd1306_logo[8][64];
+
+typedef struct
+{
+    const char *name;
+    void (*draw)(i2c_ssd1306_handle_t *display);
+} screen_t;
+
+static void draw_logo(i2c_ssd1306_handle_t *display)
+{
+    i2c_ssd1306_buffer_image(display, 32, 0, (const uint8_t *)ssd1306_logo, 64, 64, false);
+}
+
+/* Welcome screen of display_task() */
+static void draw_welcome(i2c_ssd1306_handle_t *display)
+{
+    const translations_t *t = get_translations();
+    i2c_ssd1306_buffer_text(display, 18, 0, t->esp32_airzone, false);
+    i2c_ssd1306_buffer_text(display, 28, 17, t->thermostat, false);
+    i2c_ssd1306_buffer_text(display, 38, 27, t->starting, false);
+}
+
+/* Widget layout of main.c: temperature in 3x digits, humidity and setpoint, mode label and mode */
+static void draw_main(i2c_ssd1306_handle_t *display, int32_t temperature, int32_t humidity, int32_t setpoint, const char *label, const char *mode)
+{
+    static const num_format_t temperature_format = {.decimals = 1, .unit = "\xC2\xB0"};
+    static const num_format_t setpoint_format = {.decimals = 1, .prefix = "(", .unit = ")"};
+    static const num_format_t humidity_format = {.decimals = 1, .unit = " %"};
+    char text[24];
+
+    num_format(text, sizeof(text), temperature, &temperature_format);
+    i2c_ssd1306_buffer_text_scaled(display, 0, 0, text, 3, false);
+    num_format(text, sizeof(text), humidity, &humidity_format);
+    i2c_ssd1306_buffer_text(display, 0, 28, text, false);
+    num_format(text, sizeof(text), setpoint, &setpoint_format);
+    i2c_ssd1306_buffer_text(display, 64, 28, text, false);
+    i2c_ssd1306_buffer_text(display, 0, 42, label, false);
+    i2c_ssd1306_buffer_text(display, 0, 52, mode, false);
+}
+
+static void draw_cooling(i2c_ssd1306_handle_t *display)
+{
+    const translations_t *t = get_translations();
+    draw_main(display, 234, 456, 220, t->mode_label, t->mode_cool);
+}
+
+static void draw_heating(i2c_ssd1306_handle_t *display)
+{
+    const translations_t *t = get_translations();
+    draw_main(display, -15, 1000, 185, t->mode_label, t->mode_heat);
+}
+
+static void draw_stale(i2c_ssd1306_handle_t *display)
+{
+    const translations_t *t = get_translations();
+    draw_main(display, 234, 456, 220, t->check_wiring, t->mode_cool);
+}
+
+static const screen_t screens[] = {
+    {"logo", draw_logo},
+    {"welcome", draw_welcome},
+    {"cooling", draw_cooling},
+    {"heating", draw_heating},
+    {"stale", draw_stale},
+};
+
+static bool ram_matches_buffer(const ssd1306_ram_t *ram, const i2c_ssd1306_handle_t *display)
+{
+    for (uint8_t page = 0; page < display->total_pages; page++)
+    {
+        if (memcmp(ram->gram[page], display->page[page].segment, display->width) != 0)
+            return false;
+    }
+    return true;
+}
+
+/* No data reaches the controller while it scrolls, and the first flush after the scroll stops sends the whole frame again */
+static int check_scroll(ssd1306_ram_t *ram, i2c_ssd1306_handle_t *display)
+{
+    int failures = 0;
+    if (i2c_ssd1306_scroll_horizontal(display, SSD1306_SCROLL_LEFT, 0, display->total_pages - 1, SSD1306_SCROLL_5_FRAMES) != ESP_OK || !ram->scrolling)
+    {
+        fprintf(stderr, "scroll: the controller is not scrolling\n");
+        failures++;
+    }
+
+    i2c_ssd1306_buffer_fill_space(display, 0, 7, 0, 7, true);
+    uint32_t bytes_before = ram->bytes_received;
+    esp_log_level_t log_level = host_log_level;
+    host_log_level = ESP_LOG_NONE;
+    esp_err_t err = i2c_ssd1306_buffer_diff_to_ram(display);
+    host_log_level = log_level;
+    if (err != ESP_ERR_INVALID_STATE || ram->bytes_received != bytes_before)
+    {
+        fprintf(stderr, "scroll: a flush went through while scrolling\n");
+        failures++;
+    }
+
+    if (i2c_ssd1306_scroll_stop(display) != ESP_OK || ram->scrolling)
+    {
+        fprintf(stderr, "scroll: the controller did not stop scrolling\n");
+        failures++;
+    }
+    bytes_before = ram->bytes_received;
+    if (i2c_ssd1306_buffer_diff_to_ram(display) != ESP_OK || ram->bytes_received - bytes_before < (uint32_t)display->total_pages * display->width ||
+        !ram_matches_buffer(ram, display))
+    {
+        fprintf(stderr, "scroll: the flush after the scroll did not resend the whole frame\n");
+        failures++;
+    }
+    printf("scroll: flushes refused while scrolling, full flush after it\n");
+
+    return failures;
+}
+
+static bool files_equal(const char *a, const char *b)
+{
+    FILE *fa = fopen(a, "rb");
+    FILE *fb = fopen(b, "rb");
+    bool equal = fa != NULL && fb != NULL;
+    while (equal)
+    {
+        int ca = fgetc(fa);
+        int cb = fgetc(fb);
+        equal = ca == cb;
+        if (ca == EOF || cb == EOF)
+            break;
+    }
+    if (fa)
+        fclose(fa);
+    if (fb)
+        fclose(fb);
+    return equal;
+}
+
+static bool write_frame(const ssd1306_ram_t *ram, const char *path)
+{
+    FILE *out = fopen(path, "wb");
+    if (out == NULL)
+        return false;
+    bool ok = ssd1306_ram_write_pbm(ram, out) == ESP_OK;
+    return fclose(out) == 0 && ok;
+}
+
+int main(int argc, char **argv)
+{
+    const char *output_dir = argc > 1 ? argv[1] : ".";
+    const char *reference_dir = argc > 2 && strcmp(argv[2], "--update") != 0 ? argv[2] : NULL;
+    bool update = argc > 2 && strcmp(argv[argc - 1], "--update") == 0;
+
+    static ssd1306_ram_t ram;
+    static i2c_ssd1306_handle_t display;
+    ssd1306_transport_t transport;
+    i2c_ssd1306_config_t config = {.width = 128, .height = 64, .wise = SSD1306_BOTTOM_TO_TOP, .addr_mode = SSD1306_ADDR_MODE_HORIZONTAL};
+    if (ssd1306_ram_transport_init(&ram, config.width, config.height, &transport) != ESP_OK ||
+        i2c_ssd1306_init_transport(transport, config, &display) != ESP_OK)
+    {
+        fprintf(stderr, "Failed to initialize the in-memory display\n");
+        return 1;
+    }
+    set_language(LANG_SPANISH);
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(screens) / sizeof(screens[0]); i++)
+    {
+        i2c_ssd1306_buffer_clear(&display);
+        screens[i].draw(&display);
+        /* The first screen is a full flush, the rest only send what changed since the previous one */
+        esp_err_t err = i == 0 ? i2c_ssd1306_buffer_to_ram(&display) : i2c_ssd1306_buffer_diff_to_ram(&display);
+        if (err != ESP_OK || !ram_matches_buffer(&ram, &display))
+        {
+            fprintf(stderr, "%s: controller GDDRAM does not match the buffer after the flush\n", screens[i].name);
+            failures++;
+        }
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.pbm", update && reference_dir ? reference_dir : output_dir, screens[i].name);
+        if (!write_frame(&ram, path))
+        {
+            fprintf(stderr, "%s: failed to write %s\n", screens[i].name, path);
+            failures++;
+            continue;
+        }
+        if (reference_dir && !update)
+        {
+            char reference[512];
+            snprintf(reference, sizeof(reference), "%s/%s.pbm", reference_dir, screens[i].name);
+            if (!files_equal(path, reference))
+            {
+                fprintf(stderr, "%s: %s differs from %s\n", screens[i].name, path, reference);
+                failures++;
+            }
+        }
+        printf("%s: %s, %lu bytes sent in %lu transactions so far\n", screens[i].name, path,
+               (unsigned long)ram.bytes_received, (unsigned long)ram.transactions);
+    }
+
+    failures += check_scroll(&ram, &display);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,267 @@
+/* PID control simulation - runs the firmware's relay, sensor filter, PID, slow PWM and autotune modules against a room heated by
+   a radiator, and checks:
+   - autotune gains against the Tyreus-Luyben rules for a synthetic oscillation of known amplitude and period,
+   - anti-windup: no overshoot after hours of saturated heat-up, where an unclamped integral overshoots by degrees,
+   - PI against on/off control: overshoot, settling time, steady error and relay cycles per hour, printed as CSV.
+   Exits with an error if any check failed. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "pid_autotune.h"
+#include "pid_control.h"
+#include "relay.h"
+#include "sensor_filter.h"
+
+/* Firmware constants from main.c */
+#define TEMP_MARGIN DECI(1.0)
+#define RELAY_MIN_ON_MS 180000
+#define RELAY_MIN_OFF_MS 300000
+#define PID_SAMPLE_MS 30000
+#define PID_PWM_WINDOW_MS 1200000
+#define PID_AUTOTUNE_HYSTERESIS DECI(0.2)
+
+#define SETPOINT DECI(21.0)
+#define SENSOR_PERIOD_S 2
+#define RUN_S (12 * 3600)
+#define STEADY_FROM_S (4 * 3600)
+#define SETTLE_BAND_C 0.5
+
+/* Room losing heat to the outside with a 3 h time constant, heated by a radiator that lags the relay by 15 min */
+typedef struct
+{
+    double outside;
+    double radiator_gain;
+    double room;
+    double radiator;
+} plant_t;
+
+#define ROOM_TAU_S (3 * 3600.0)
+#define RADIATOR_TAU_S 900.0
+
+static void plant_step(plant_t *plant, bool on, double dt_s)
+{
+    plant->radiator += ((on ? plant->radiator_gain : 0) - plant->radiator) / RADIATOR_TAU_S * dt_s;
+    plant->room += ((plant->outside - plant->room) + plant->radiator) / ROOM_TAU_S * dt_s;
+}
+
+static uint32_t random_state = 2;
+
+/* Reading with +-0.1 C of noise, through the firmware's filter */
+static deci_t sense(const plant_t *plant, sensor_filter_t *filter, deci_t last)
+{
+    random_state = random_state * 1664525u + 1013904223u;
+    double measured = plant->room + ((int)(random_state >> 30) % 3 - 1) * 0.1;
+    deci_t filtered = last;
+    sensor_filter_update(filter, (deci_t)lround(measured * 10), &filtered);
+    return filtered;
+}
+
+typedef enum {
+    CONTROL_ON_OFF,
+    CONTROL_PI,
+    CONTROL_AUTOTUNE,
+} control_t;
+
+typedef struct
+{
+    const char *name;
+    double reach_s;          // First time at the setpoint
+    double overshoot_c;      // Highest excursion above the setpoint in the 3 h after reaching it
+    double settle_s;         // From then on within SETTLE_BAND_C of the setpoint, -1 if never
+    double steady_mean_c;
+    double steady_rms_c;
+    double starts_per_hour;
+    int64_t integral_max;    // Largest PID integral seen
+} run_result_t;
+
+typedef struct
+{
+    control_t control;
+    plant_t plant;
+    pid_gains_t gains;       // In: PI gains. Out: autotune gains.
+    bool unclamped;          // PI with a plain integral, to show what anti-windup prevents
+    bool tuned;              // Out: autotune finished
+    double tune_hours;
+} run_t;
+
+/* Textbook PI with an unclamped integral in the same units as pid_update(), for comparison only */
+static int32_t windup_pi(const pid_gains_t *gains, int64_t *integral, deci_t measurement, uint32_t dt_ms)
+{
+    int32_t error = SETPOINT - measurement;
+    *integral += (int64_t)gains->ki * error * dt_ms / 1000;
+    int64_t output = ((int64_t)gains->kp * error + *integral) >> PID_GAIN_SHIFT;
+    return output < 0 ? 0 : output > PID_OUTPUT_MAX ? PID_OUTPUT_MAX : (int32_t)output;
+}
+
+static run_result_t simulate(run_t *run, uint32_t duration_s)
+{
+    static double room[RUN_S];
+    plant_t plant = run->plant;
+    sensor_filter_t filter;
+    relay_t relay;
+    pid_controller_t pid;
+    slow_pwm_t pwm;
+    pid_autotune_t tune;
+    int64_t windup_integral = 0;
+    int64_t pid_updated_us = -1;
+    int32_t output = 0;
+    deci_t measurement = (deci_t)lround(plant.room * 10);
+    run_result_t result = {.reach_s = -1, .settle_s = -1};
+
+    random_state = 2;
+    sensor_filter_reset(&filter);
+    relay_init(&relay, GPIO_NUM_0, RELAY_MIN_ON_MS, RELAY_MIN_OFF_MS, -(int64_t)RELAY_MIN_OFF_MS * 1000);
+    pid_reset(&pid, &run->gains, false);
+    slow_pwm_reset(&pwm, PID_PWM_WINDOW_MS, RELAY_MIN_ON_MS, RELAY_MIN_OFF_MS);
+    pid_autotune_start(&tune, SETPOINT, PID_AUTOTUNE_HYSTERESIS, false, 0);
+
+    uint32_t t;
+    for (t = 0; t < duration_s; t++)
+    {
+        int64_t now_us = (int64_t)t * 1000000;
+        if (t % SENSOR_PERIOD_S == 0)
+            measurement = sense(&plant, &filter, measurement);
+
+        bool demand = false;
+        if (run->control == CONTROL_ON_OFF)
+        {
+            deci_t excess = SETPOINT - measurement;
+            demand = excess > TEMP_MARGIN ? true : excess <= 0 ? false : relay.on;
+        }
+        else if (run->control == CONTROL_AUTOTUNE)
+        {
+            if (pid_autotune_update(&tune, measurement, now_us, &demand) != PID_AUTOTUNE_RUNNING)
+                break;
+        }
+        else
+        {
+            if (pid_updated_us < 0 || now_us - pid_updated_us >= (int64_t)PID_SAMPLE_MS * 1000)
+            {
+                uint32_t dt_ms = pid_updated_us < 0 ? 0 : (uint32_t)((now_us - pid_updated_us) / 1000);
+                output = run->unclamped ? windup_pi(&run->gains, &windup_integral, measurement, dt_ms) : pid_update(&pid, SETPOINT, measurement, dt_ms);
+                pid_updated_us = now_us;
+                int64_t integral = run->unclamped ? windup_integral : pid.integral;
+                if (integral > result.integral_max)
+                    result.integral_max = integral;
+            }
+            demand = slow_pwm_update(&pwm, output, now_us);
+        }
+        relay_request(&relay, demand, now_us);
+        plant_step(&plant, relay.on, 1);
+        room[t] = plant.room;
+    }
+
+    if (run->control == CONTROL_AUTOTUNE)
+    {
+        run->tuned = pid_autotune_gains(&tune, &run->gains);
+        run->tune_hours = t / 3600.0;
+        return result;
+    }
+
+    double target = SETPOINT / 10.0;
+    for (t = 0; t < duration_s && result.reach_s < 0; t++)
+        if (room[t] >= target - 0.05)
+            result.reach_s = t;
+    result.overshoot_c = 0;
+    for (t = (uint32_t)(result.reach_s < 0 ? duration_s : result.reach_s); t < duration_s && t < result.reach_s + 3 * 3600; t++)
+        if (room[t] - target > result.overshoot_c)
+            result.overshoot_c = room[t] - target;
+    for (t = duration_s; t > 0 && fabs(room[t - 1] - target) <= SETTLE_BAND_C; t--)
+        ;
+    if (t < duration_s)
+        result.settle_s = t;
+    double sum = 0, squares = 0;
+    for (t = STEADY_FROM_S; t < duration_s; t++)
+    {
+        sum += room[t] - target;
+        squares += (room[t] - target) * (room[t] - target);
+    }
+    result.steady_mean_c = sum / (duration_s - STEADY_FROM_S);
+    result.steady_rms_c = sqrt(squares / (duration_s - STEADY_FROM_S));
+    result.starts_per_hour = relay.starts / (duration_s / 3600.0);
+    return result;
+}
+
+/* A measured oscillation of 0.5 C amplitude and 40 min period, independent of the relay, must give the textbook gains:
+   Ku = 4d / (pi * a) with a corrected for the hysteresis, Kp = Ku / 3.2, Ti = 2.2 Tu */
+static void check_tyreus_luyben(void)
+{
+    const double amplitude_c = 0.5;
+    const double period_s = 40 * 60;
+    pid_autotune_t tune;
+    pid_autotune_start(&tune, SETPOINT, PID_AUTOTUNE_HYSTERESIS, false, 0);
+    bool on;
+    for (uint32_t t = 0; pid_autotune_update(&tune, (deci_t)lround(SETPOINT + amplitude_c * 10 * sin(2 * M_PI * t / period_s)),
+                                             (int64_t)t * 1000000, &on) == PID_AUTOTUNE_RUNNING;
+         t += SENSOR_PERIOD_S)
+        ;
+
+    pid_gains_t gains;
+    bool tuned = pid_autotune_gains(&tune, &gains);
+    double a_tenths = sqrt(pow(amplitude_c * 10, 2) - pow(PID_AUTOTUNE_HYSTERESIS, 2));
+    double ku = 4 * (PID_OUTPUT_MAX / 2.0) / (M_PI * a_tenths);
+    double kp = ku / 3.2 * (1 << PID_GAIN_SHIFT);
+    double ki = kp / (2.2 * period_s);
+    printf("known oscillation: kp %ld (expected %.0f), ki %ld (expected %.0f), kd %ld\n", (long)gains.kp, kp, (long)gains.ki, ki, (long)gains.kd);
+    bench_check(tuned && tune.state == PID_AUTOTUNE_DONE, "autotune finishes on a steady oscillation");
+    bench_check(tuned && fabs(gains.kp - kp) / kp < 0.03, "Kp within 3%% of Ku / 3.2");
+    bench_check(tuned && fabs(gains.ki - ki) / ki < 0.03, "Ki within 3%% of Kp / (2.2 Tu)");
+    bench_check(tuned && gains.kd == 0, "no derivative gain");
+}
+
+int main(void)
+{
+    check_tyreus_luyben();
+
+    /* Outside at 8 C, the radiator can hold the room 22 C above it */
+    plant_t room = {.outside = 8, .radiator_gain = 22, .room = 17};
+    run_t tune = {.control = CONTROL_AUTOTUNE, .plant = room};
+    simulate(&tune, 24 * 3600);
+    printf("autotune on the room: %s in %.1f h, kp %ld, ki %ld\n", tune.tuned ? "done" : "failed", tune.tune_hours, (long)tune.gains.kp,
+           (long)tune.gains.ki);
+    bench_check(tune.tuned, "autotune finishes on the simulated room");
+
+    run_t on_off = {.control = CONTROL_ON_OFF, .plant = room};
+    run_t pi = {.control = CONTROL_PI, .plant = room, .gains = tune.gains};
+    run_result_t results[4];
+    results[0] = simulate(&on_off, RUN_S);
+    results[0].name = "on_off";
+    results[1] = simulate(&pi, RUN_S);
+    results[1].name = "pi";
+
+    /* Cold night, outside at 0 C: hours at full power before the room gets near the setpoint */
+    plant_t cold = {.outside = 0, .radiator_gain = 24, .room = 10};
+    run_t saturated = {.control = CONTROL_PI, .plant = cold, .gains = tune.gains};
+    run_t windup = saturated;
+    windup.unclamped = true;
+    results[2] = simulate(&saturated, RUN_S);
+    results[2].name = "pi_cold_start";
+    results[3] = simulate(&windup, RUN_S);
+    results[3].name = "pi_cold_start_unclamped";
+
+    printf("\ncontrol,reach_min,overshoot_c,settle_min,steady_mean_c,steady_rms_c,starts_per_h\n");
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++)
+    {
+        printf("%s,%.0f,%.2f,%.0f,%+.2f,%.2f,%.1f\n", results[i].name, results[i].reach_s / 60, results[i].overshoot_c,
+               results[i].settle_s < 0 ? -1 : results[i].settle_s / 60, results[i].steady_mean_c, results[i].steady_rms_c, results[i].starts_per_hour);
+    }
+    printf("\n");
+
+    bench_check(results[2].reach_s > 4 * 3600, "the cold start saturates the output for hours");
+    bench_check(results[2].integral_max <= (int64_t)PID_OUTPUT_MAX << PID_GAIN_SHIFT, "the integral stays within the output range");
+    bench_check(results[2].overshoot_c < 0.5, "no overshoot after the saturated heat-up");
+    bench_check(results[3].overshoot_c > 1.0, "an unclamped integral overshoots after the same heat-up");
+    bench_check(results[1].overshoot_c < 0.5, "PI overshoot below 0.5 C");
+    bench_check(fabs(results[1].steady_mean_c) < fabs(results[0].steady_mean_c), "PI steady error below on/off");
+    bench_check(results[1].steady_rms_c < results[0].steady_rms_c, "PI steady RMS below on/off");
+    bench_check(results[1].starts_per_hour <= 3.0, "PI relay starts at most 3 per hour");
+
+    if (bench_failures())
+    {
+        fprintf(stderr, "%d checks failed\n", bench_failures());
+        return 1;
+    }
+    return 0;
+}
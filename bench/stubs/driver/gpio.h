@@ -0,0 +1,16 @@
+#pragma once
+
+/* Host stand-in for the GPIO driver. gpio_set_level() records the last level of each pin in host_gpio_level. */
+
+#include "esp_err.h"
+
+typedef enum
+{
+    GPIO_NUM_NC = -1,
+    GPIO_NUM_0 = 0,
+    GPIO_NUM_MAX = 40
+} gpio_num_t;
+
+extern uint32_t host_gpio_level[GPIO_NUM_MAX];
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level);
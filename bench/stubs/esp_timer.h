@@ -0,0 +1,7 @@
+#pragma once
+
+/* Host stand-in for esp_timer: microseconds of the monotonic clock. */
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,188 @@
+/* Sensor filter test - asserts the median and EMA output on a known sequence, the rejection of a single outlier, the forced
+   re-accept after SENSOR_FILTER_MAX_REJECTS consecutive rejects at one level and no re-accept after alternating glitches, then
+   replays 24 h of noisy readings at 2 s and reports how many relay toggles the filter avoids with threshold control at 21.0 C.
+   Exits with an error if any check failed. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "sensor_filter.h"
+
+#define REPLAY_PERIOD_S 2
+#define REPLAY_READINGS (24 * 3600 / REPLAY_PERIOD_S)
+#define REPLAY_THRESHOLD DECI(21.0)
+
+static void check_median_ema(void)
+{
+    /* Expected output worked out by hand: median of the window, EMA weight 1/4 with 4 fraction bits, rounded to tenths */
+    static const deci_t raw[] = {200, 210, 190, 205, 201, 207, 195};
+    static const deci_t expected[] = {200, 203, 202, 203, 202, 203, 203};
+    sensor_filter_t filter;
+    sensor_filter_reset(&filter);
+    for (size_t i = 0; i < sizeof(raw) / sizeof(raw[0]); i++)
+    {
+        deci_t filtered = 0;
+        bool accepted = sensor_filter_update(&filter, raw[i], &filtered);
+        bench_check(accepted && filtered == expected[i], "reading %u: raw %d gave %d (%s), expected %d", (unsigned)i, raw[i], filtered,
+                    accepted ? "accepted" : "rejected", expected[i]);
+    }
+
+    deci_t filtered = 0;
+    sensor_filter_reset(&filter);
+    bench_check(sensor_filter_update(&filter, DECI(-1.5), &filtered) && filtered == DECI(-1.5), "a negative first reading passes through");
+}
+
+static void check_outlier(void)
+{
+    sensor_filter_t filter;
+    deci_t filtered = 0;
+    sensor_filter_reset(&filter);
+    for (int i = 0; i < SENSOR_FILTER_WINDOW; i++)
+        sensor_filter_update(&filter, DECI(22.0), &filtered);
+
+    bench_check(!sensor_filter_update(&filter, DECI(22.0) + SENSOR_FILTER_MAX_STEP + 1, &filtered), "a step just over the limit is rejected");
+    bench_check(filtered == DECI(22.0), "a rejected reading leaves the output alone");
+    bench_check(sensor_filter_update(&filter, DECI(22.0), &filtered) && filtered == DECI(22.0), "the reading after an outlier is accepted");
+    bench_check(sensor_filter_update(&filter, DECI(22.0) + SENSOR_FILTER_MAX_STEP, &filtered), "a step at the limit is accepted");
+
+    /* Two outliers in a row are still dropped and the count starts over after an accepted reading */
+    sensor_filter_reset(&filter);
+    sensor_filter_update(&filter, DECI(22.0), &filtered);
+    bench_check(!sensor_filter_update(&filter, DECI(85.0), &filtered), "first of two outliers is rejected");
+    bench_check(!sensor_filter_update(&filter, DECI(-40.0), &filtered), "second of two outliers is rejected");
+    bench_check(sensor_filter_update(&filter, DECI(22.1), &filtered) && filtered == DECI(22.0), "back to the level after two outliers");
+    bench_check(!sensor_filter_update(&filter, DECI(30.0), &filtered), "reject count restarts after an accepted reading");
+}
+
+static void check_forced_accept(void)
+{
+    sensor_filter_t filter;
+    deci_t filtered = 0;
+    sensor_filter_reset(&filter);
+    for (int i = 0; i < SENSOR_FILTER_WINDOW; i++)
+        sensor_filter_update(&filter, DECI(20.0), &filtered);
+
+    for (int i = 1; i < SENSOR_FILTER_MAX_REJECTS; i++)
+        bench_check(!sensor_filter_update(&filter, DECI(30.0), &filtered), "a new level is rejected until it persists");
+    bench_check(sensor_filter_update(&filter, DECI(30.0), &filtered), "a level that persists is accepted");
+    bench_check(filtered == DECI(30.0), "the filter restarts from the persisting level");
+    bench_check(sensor_filter_update(&filter, DECI(30.4), &filtered) && filtered == DECI(30.1), "filtering resumes from the new level");
+}
+
+static void check_alternating_glitches(void)
+{
+    sensor_filter_t filter;
+    deci_t filtered = 0;
+    sensor_filter_reset(&filter);
+    for (int i = 0; i < SENSOR_FILTER_WINDOW; i++)
+        sensor_filter_update(&filter, DECI(20.0), &filtered);
+
+    /* Spikes on both sides do not agree on a level, so none of them restarts the filter */
+    static const deci_t spikes[] = {DECI(30.0), DECI(10.0), DECI(30.0), DECI(10.0), DECI(30.0), DECI(10.0)};
+    for (size_t i = 0; i < sizeof(spikes) / sizeof(spikes[0]); i++)
+        bench_check(!sensor_filter_update(&filter, spikes[i], &filtered), "alternating glitches are all rejected");
+    bench_check(filtered == DECI(20.0), "alternating glitches leave the output alone");
+    bench_check(sensor_filter_update(&filter, DECI(20.1), &filtered) && filtered == DECI(20.0), "the level before the glitches is kept");
+
+    /* A new level still wins once it repeats, even right after a glitch on the other side */
+    bench_check(!sensor_filter_update(&filter, DECI(10.0), &filtered), "a glitch before a new level is rejected");
+    for (int i = 1; i < SENSOR_FILTER_MAX_REJECTS; i++)
+        bench_check(!sensor_filter_update(&filter, DECI(30.0) + i, &filtered), "a new level close to its first reject is held back");
+    bench_check(sensor_filter_update(&filter, DECI(30.0), &filtered) && filtered == DECI(30.0), "the new level is accepted once it persists");
+}
+
+/* Deterministic noise, so the replay numbers only change with the filter */
+static uint32_t random_state = 7;
+
+static double next_uniform(void)
+{
+    random_state = random_state * 1664525u + 1013904223u;
+    return ((random_state >> 8) + 0.5) / 16777216.0;
+}
+
+static double next_gaussian(void)
+{
+    return sqrt(-2 * log(next_uniform())) * cos(2 * M_PI * next_uniform());
+}
+
+typedef enum {
+    TRACE_DHT11,
+    TRACE_DHT22,
+    TRACE_DHT22_GLITCHES,
+} trace_kind_t;
+
+static void replay(trace_kind_t kind, const char *name)
+{
+    sensor_filter_t filter;
+    sensor_filter_reset(&filter);
+    bool raw_on = false;
+    bool filtered_on = false;
+    uint32_t raw_toggles = 0;
+    uint32_t filtered_toggles = 0;
+    uint32_t glitches = 0;
+    uint32_t glitches_passed = 0;
+    uint32_t rejected = 0;
+    double error_sum = 0;
+
+    for (uint32_t i = 0; i < REPLAY_READINGS; i++)
+    {
+        /* Slow 2 h swing with a 15 min ripple around 22 C */
+        double t = (double)i * REPLAY_PERIOD_S;
+        double truth = 22.0 + 1.5 * sin(2 * M_PI * t / 7200) + 0.3 * sin(2 * M_PI * t / 900);
+        deci_t raw = kind == TRACE_DHT11 ? (deci_t)(lround(truth + 0.4 * next_gaussian()) * 10) : (deci_t)lround((truth + 0.3 * next_gaussian()) * 10);
+        bool glitch = kind == TRACE_DHT22_GLITCHES && next_uniform() < 0.01;
+        if (glitch)
+        {
+            raw += (next_uniform() < 0.5 ? -1 : 1) * (50 + (int)(next_uniform() * 300));
+            glitches++;
+        }
+
+        if ((raw > REPLAY_THRESHOLD) != raw_on)
+        {
+            raw_on = !raw_on;
+            raw_toggles++;
+        }
+        deci_t filtered;
+        if (!sensor_filter_update(&filter, raw, &filtered))
+        {
+            rejected++;
+            continue;
+        }
+        glitches_passed += glitch;
+        error_sum += fabs(filtered / 10.0 - truth);
+        if ((filtered > REPLAY_THRESHOLD) != filtered_on)
+        {
+            filtered_on = !filtered_on;
+            filtered_toggles++;
+        }
+    }
+
+    double avoided = raw_toggles ? 100.0 * (raw_toggles - filtered_toggles) / raw_toggles : 0;
+    double mean_error = error_sum / (REPLAY_READINGS - rejected);
+    printf("%s,%lu,%lu,%.0f,%lu,%lu,%.2f\n", name, (unsigned long)raw_toggles, (unsigned long)filtered_toggles, avoided, (unsigned long)glitches,
+           (unsigned long)glitches_passed, mean_error);
+    bench_check(avoided >= 85, "the filter avoids most relay toggles");
+    bench_check(mean_error < 0.25, "the filtered value tracks the true temperature");
+    bench_check(glitches_passed == 0, "no glitch reaches the output");
+}
+
+int main(void)
+{
+    check_median_ema();
+    check_outlier();
+    check_forced_accept();
+    check_alternating_glitches();
+
+    printf("trace,raw_toggles,filtered_toggles,avoided_percent,glitches,glitches_passed,mean_abs_error_c\n");
+    replay(TRACE_DHT11, "dht11_1c_steps");
+    replay(TRACE_DHT22, "dht22_noise_0.3c");
+    replay(TRACE_DHT22_GLITCHES, "dht22_1pct_glitches");
+
+    if (bench_failures())
+    {
+        fprintf(stderr, "%d checks failed\n", bench_failures());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fixed-point tenths - temperatures in tenths of a degree Celsius and humidity in tenths of a percent,
+// the unit the DHT sensors report in. Sensor, filter, control and display all work in this type,
+// so none of them needs the FPU or the printf float code. Format with num_format() and 1 decimal.
+typedef int16_t deci_t;
+
+// Constant in tenths from a decimal literal, e.g. DECI(22.5) is 225. Folded at compile time.
+#define DECI(value) ((deci_t)((value) * 10 + ((value) < 0 ? -0.5 : 0.5)))
+
+// Whole and tenth digits of a non-negative value, for "%d.%d" log formats
+#define DECI_WHOLE(value) ((value) / 10)
+#define DECI_TENTH(value) ((value) % 10)
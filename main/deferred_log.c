@@ -0,0 +1,177 @@
+#include "deferred_log.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+static const char *TAG = "DEFERRED_LOG";
+
+#define DEFERRED_LOG_MESSAGE_SIZE 128
+#define DEFERRED_LOG_SPEC_SIZE 16
+
+// Ring buffer slot. The sequence tells whose turn the slot is: it equals the write position when the
+// slot is free for that position, and the write position + 1 once the record is complete. It is
+// stored relative to the slot index, so the zero-initialized buffer starts with every slot free.
+typedef struct {
+    atomic_uint sequence;
+    uint8_t level;
+    uint8_t total_args;
+    const char *tag;
+    const char *format;
+    int64_t time_us;
+    uint32_t args[DEFERRED_LOG_MAX_ARGS];
+} deferred_log_record_t;
+
+static deferred_log_record_t records[DEFERRED_LOG_CAPACITY];
+static atomic_uint write_position;
+static unsigned int read_position;
+static atomic_uint dropped;
+static TaskHandle_t drain_task_handle = NULL;
+
+static unsigned int deferred_log_sequence(unsigned int slot)
+{
+    return atomic_load_explicit(&records[slot].sequence, memory_order_acquire) + slot;
+}
+
+static void deferred_log_set_sequence(unsigned int slot, unsigned int sequence)
+{
+    atomic_store_explicit(&records[slot].sequence, sequence - slot, memory_order_release);
+}
+
+// Multi-producer, single-consumer: writers claim a position with a compare-and-swap and
+// publish the record by advancing the slot sequence, so no writer ever waits for another.
+void deferred_log_write(esp_log_level_t level, const char *tag, const char *format, uint8_t total_args, const uint32_t *args)
+{
+    unsigned int position = atomic_load_explicit(&write_position, memory_order_relaxed);
+    unsigned int slot;
+    while (1) {
+        slot = position % DEFERRED_LOG_CAPACITY;
+        int difference = (int)(deferred_log_sequence(slot) - position);
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&write_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // Buffer full - the drain task has not caught up
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            position = atomic_load_explicit(&write_position, memory_order_relaxed);
+        }
+    }
+
+    deferred_log_record_t *record = &records[slot];
+    record->level = level;
+    record->total_args = total_args < DEFERRED_LOG_MAX_ARGS ? total_args : DEFERRED_LOG_MAX_ARGS;
+    record->tag = tag;
+    record->format = format;
+    record->time_us = esp_timer_get_time();
+    memcpy(record->args, args, sizeof(record->args));
+    deferred_log_set_sequence(slot, position + 1);
+}
+
+// Format a record, one conversion at a time so every raw argument is passed with its own type
+static void deferred_log_format(const deferred_log_record_t *record, char *message, size_t size)
+{
+    const char *f = record->format;
+    size_t length = 0;
+    uint8_t arg = 0;
+
+    while (*f != '\0' && length + 1 < size) {
+        if (*f != '%') {
+            message[length++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            message[length++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Copy the conversion specification, flags, width, precision and length included
+        char spec[DEFERRED_LOG_SPEC_SIZE];
+        size_t spec_length = 0;
+        bool is_long = false;
+        spec[spec_length++] = *f++;
+        while (*f != '\0' && strchr("diouxXcsfFeEgGp", *f) == NULL && spec_length + 2 < sizeof(spec)) {
+            is_long |= (*f == 'l');
+            spec[spec_length++] = *f++;
+        }
+        if (*f == '\0') {
+            break;
+        }
+        char conversion = *f++;
+        spec[spec_length++] = conversion;
+        spec[spec_length] = '\0';
+
+        uint32_t word = arg < record->total_args ? record->args[arg] : 0;
+        arg++;
+        int written;
+        switch (conversion) {
+            case 's':
+                written = snprintf(message + length, size - length, spec, (const char *)(uintptr_t)word);
+                break;
+            case 'p':
+                written = snprintf(message + length, size - length, spec, (void *)(uintptr_t)word);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+                float value;
+                memcpy(&value, &word, sizeof(value));
+                written = snprintf(message + length, size - length, spec, (double)value);
+                break;
+            }
+            case 'd': case 'i': case 'c':
+                written = is_long ? snprintf(message + length, size - length, spec, (long)(int32_t)word)
+                                  : snprintf(message + length, size - length, spec, (int)(int32_t)word);
+                break;
+            default:
+                written = is_long ? snprintf(message + length, size - length, spec, (unsigned long)word)
+                                  : snprintf(message + length, size - length, spec, (unsigned int)word);
+                break;
+        }
+        if (written < 0) {
+            break;
+        }
+        length += (size_t)written < size - length ? (size_t)written : size - length - 1;
+    }
+    message[length] = '\0';
+}
+
+// Drain task - formats and prints the records in order at low priority
+static void deferred_log_drain_task(void *pvParameter)
+{
+    char message[DEFERRED_LOG_MESSAGE_SIZE];
+
+    while (1) {
+        unsigned int slot = read_position % DEFERRED_LOG_CAPACITY;
+        if (deferred_log_sequence(slot) != read_position + 1) {
+            unsigned int lost = atomic_exchange_explicit(&dropped, 0, memory_order_relaxed);
+            if (lost > 0) {
+                ESP_LOGW(TAG, "%u log records dropped", lost);
+            }
+            vTaskDelay(pdMS_TO_TICKS(DEFERRED_LOG_DRAIN_PERIOD_MS));
+            continue;
+        }
+
+        const deferred_log_record_t *record = &records[slot];
+        deferred_log_format(record, message, sizeof(message));
+        ESP_LOG_LEVEL((esp_log_level_t)record->level, record->tag, "[%lld ms] %s", record->time_us / 1000, message);
+
+        // Hand the slot back to the writers for its next lap
+        deferred_log_set_sequence(slot, read_position + DEFERRED_LOG_CAPACITY);
+        read_position++;
+    }
+}
+
+void deferred_log_start(void)
+{
+    if (drain_task_handle != NULL) {
+        return;
+    }
+    xTaskCreate(deferred_log_drain_task, "log_drain", DEFERRED_LOG_DRAIN_STACK_SIZE, NULL,
+                DEFERRED_LOG_DRAIN_PRIORITY, &drain_task_handle);
+}
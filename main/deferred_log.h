@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_log.h"
+
+// Deferred logging - records a compact binary entry (level, tag, format, raw args, timestamp)
+// into a lock-free ring buffer, and a low-priority drain task does the formatting and UART output.
+// Tags, formats and %s arguments are stored by pointer, so they must be string literals or other
+// strings that outlive the drain. At most DEFERRED_LOG_MAX_ARGS arguments of 32 bits or less;
+// float and double arguments are recorded as float.
+
+#define DEFERRED_LOG_MAX_ARGS 4
+#define DEFERRED_LOG_CAPACITY 64           // Records, must be a power of two
+#define DEFERRED_LOG_DRAIN_PERIOD_MS 100
+#define DEFERRED_LOG_DRAIN_STACK_SIZE 3072
+#define DEFERRED_LOG_DRAIN_PRIORITY 1
+
+// Start the drain task. Records written before it starts are kept until the buffer is full.
+void deferred_log_start(void);
+
+// Record a log entry. Never blocks; the entry is dropped and counted if the buffer is full.
+void deferred_log_write(esp_log_level_t level, const char *tag, const char *format, uint8_t total_args, const uint32_t *args);
+
+// Argument packing - every argument is stored as one 32-bit word
+static inline uint32_t deferred_log_int(int32_t value) { return (uint32_t)value; }
+static inline uint32_t deferred_log_uint(uint32_t value) { return value; }
+static inline uint32_t deferred_log_ptr(const void *value) { return (uint32_t)(uintptr_t)value; }
+static inline uint32_t deferred_log_float(double value)
+{
+    float f = (float)value;
+    uint32_t word;
+    __builtin_memcpy(&word, &f, sizeof(word));
+    return word;
+}
+
+#define DEFERRED_LOG_WORD(x) _Generic((x), \
+    float: deferred_log_float, \
+    double: deferred_log_float, \
+    char *: deferred_log_ptr, \
+    const char *: deferred_log_ptr, \
+    unsigned int: deferred_log_uint, \
+    unsigned long: deferred_log_uint, \
+    default: deferred_log_int)(x)
+
+#define DEFERRED_LOG_NARGS(...) DEFERRED_LOG_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+#define DEFERRED_LOG_NARGS_(_0, _1, _2, _3, _4, N, ...) N
+
+#define DEFERRED_LOG_WORDS(...) DEFERRED_LOG_WORDS_N(DEFERRED_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+#define DEFERRED_LOG_WORDS_N(n, ...) DEFERRED_LOG_WORDS_N_(n, ##__VA_ARGS__)
+#define DEFERRED_LOG_WORDS_N_(n, ...) DEFERRED_LOG_WORDS_##n(__VA_ARGS__)
+#define DEFERRED_LOG_WORDS_0(...) 0
+#define DEFERRED_LOG_WORDS_1(a) DEFERRED_LOG_WORD(a)
+#define DEFERRED_LOG_WORDS_2(a, b) DEFERRED_LOG_WORD(a), DEFERRED_LOG_WORD(b)
+#define DEFERRED_LOG_WORDS_3(a, b, c) DEFERRED_LOG_WORD(a), DEFERRED_LOG_WORD(b), DEFERRED_LOG_WORD(c)
+#define DEFERRED_LOG_WORDS_4(a, b, c, d) DEFERRED_LOG_WORD(a), DEFERRED_LOG_WORD(b), DEFERRED_LOG_WORD(c), DEFERRED_LOG_WORD(d)
+
+#define DEFERRED_LOG(level, tag, format, ...) \
+    deferred_log_write(level, tag, format, DEFERRED_LOG_NARGS(__VA_ARGS__), \
+                       (const uint32_t[DEFERRED_LOG_MAX_ARGS]){ DEFERRED_LOG_WORDS(__VA_ARGS__) })
+
+// Drop-in replacements for ESP_LOGE/ESP_LOGW/ESP_LOGI on hot paths
+#define DLOGE(tag, format, ...) DEFERRED_LOG(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define DLOGW(tag, format, ...) DEFERRED_LOG(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define DLOGI(tag, format, ...) DEFERRED_LOG(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
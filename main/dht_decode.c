@@ -0,0 +1,97 @@
+#include "dht_decode.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define DHT_DECODE_DATA_BITS (DHT_DECODE_DATA_BYTES * 8)
+
+// Walks the pulses, merging glitches into the level around them
+typedef struct {
+    const dht_pulse_t *pulses;
+    size_t total_pulses;
+    size_t next;
+} dht_decode_cursor_t;
+
+static bool dht_decode_next(dht_decode_cursor_t *cursor, dht_pulse_t *pulse)
+{
+    if (cursor->next >= cursor->total_pulses) {
+        return false;
+    }
+    *pulse = cursor->pulses[cursor->next++];
+    if (pulse->duration_us == 0) {
+        cursor->next = cursor->total_pulses;
+        return true;
+    }
+
+    // A short pulse followed by a pulse of our level is a glitch inside our pulse
+    while (cursor->next + 1 < cursor->total_pulses &&
+           cursor->pulses[cursor->next].duration_us < DHT_DECODE_GLITCH_US &&
+           cursor->pulses[cursor->next + 1].level == pulse->level &&
+           cursor->pulses[cursor->next + 1].duration_us != 0) {
+        uint32_t duration = (uint32_t)pulse->duration_us + cursor->pulses[cursor->next].duration_us +
+                            cursor->pulses[cursor->next + 1].duration_us;
+        pulse->duration_us = duration > UINT16_MAX ? UINT16_MAX : duration;
+        cursor->next += 2;
+    }
+    return true;
+}
+
+dht_decode_result_t dht_decode(const dht_pulse_t *pulses, size_t total_pulses, uint8_t data[DHT_DECODE_DATA_BYTES])
+{
+    dht_decode_cursor_t cursor = { .pulses = pulses, .total_pulses = total_pulses, .next = 0 };
+    dht_pulse_t low, high;
+
+    // Skip the tail of the start pulse and the host release until the sensor's response
+    if (!dht_decode_next(&cursor, &low)) {
+        return DHT_DECODE_NO_RESPONSE;
+    }
+    while (1) {
+        if (!dht_decode_next(&cursor, &high)) {
+            return DHT_DECODE_NO_RESPONSE;
+        }
+        if (low.level == 0 && low.duration_us >= DHT_DECODE_RESPONSE_MIN_US &&
+            high.level == 1 && high.duration_us >= DHT_DECODE_RESPONSE_MIN_US) {
+            break;
+        }
+        low = high;
+    }
+
+    memset(data, 0, DHT_DECODE_DATA_BYTES);
+    for (uint8_t bit = 0; bit < DHT_DECODE_DATA_BITS; bit++) {
+        if (!dht_decode_next(&cursor, &low) || !dht_decode_next(&cursor, &high) ||
+            low.duration_us == 0 || high.duration_us == 0) {
+            return DHT_DECODE_TRUNCATED;
+        }
+        if (low.level != 0 || high.level != 1 ||
+            low.duration_us < DHT_DECODE_BIT_LOW_MIN_US || low.duration_us > DHT_DECODE_BIT_MAX_US ||
+            high.duration_us > DHT_DECODE_BIT_MAX_US) {
+            return DHT_DECODE_BAD_TIMING;
+        }
+        // Fixed threshold halfway between the 0 and 1 highs, it keeps twice the margin of
+        // comparing each high with its low when both pulses jitter
+        data[bit / 8] <<= 1;
+        data[bit / 8] |= high.duration_us >= DHT_DECODE_BIT_ONE_MIN_US;
+    }
+
+    if (data[4] != ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
+        return DHT_DECODE_CHECKSUM;
+    }
+    return DHT_DECODE_OK;
+}
+
+const char *dht_decode_result_name(dht_decode_result_t result)
+{
+    switch (result) {
+        case DHT_DECODE_OK:
+            return "ok";
+        case DHT_DECODE_NO_RESPONSE:
+            return "no response";
+        case DHT_DECODE_TRUNCATED:
+            return "truncated";
+        case DHT_DECODE_BAD_TIMING:
+            return "bad timing";
+        case DHT_DECODE_CHECKSUM:
+            return "checksum mismatch";
+        default:
+            return "unknown";
+    }
+}
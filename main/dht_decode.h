@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Pure DHT pulse-train decoder - no GPIO, timing or RTOS dependencies, so any capture method
+// (RMT, GPIO interrupt timestamps, recorded traces on a host) can feed it.
+//
+// The input is the line as a list of (level, duration) pulses. Leading pulses before the sensor's
+// response (80 us low, 80 us high) are skipped, then every bit is a ~50 us low followed by a high
+// of ~26 us for 0 or ~70 us for 1. Pulses shorter than DHT_DECODE_GLITCH_US are treated as noise
+// and merged into the level around them.
+
+#define DHT_DECODE_DATA_BYTES 5
+#define DHT_DECODE_GLITCH_US 5
+#define DHT_DECODE_RESPONSE_MIN_US 60
+#define DHT_DECODE_BIT_LOW_MIN_US 20
+#define DHT_DECODE_BIT_ONE_MIN_US 48       // Shortest high of a 1 bit
+#define DHT_DECODE_BIT_MAX_US 120          // Longest low or high of a bit
+
+typedef struct {
+    uint8_t level;
+    uint16_t duration_us;   // 0 marks the end of the capture
+} dht_pulse_t;
+
+typedef enum {
+    DHT_DECODE_OK = 0,
+    DHT_DECODE_NO_RESPONSE,    // The sensor never answered
+    DHT_DECODE_TRUNCATED,      // The capture ended before the 40th bit
+    DHT_DECODE_BAD_TIMING,     // A bit pulse is outside the expected durations
+    DHT_DECODE_CHECKSUM,       // All bits received, the checksum does not match
+} dht_decode_result_t;
+
+// Decode the pulses into the 5 data bytes (humidity, temperature, checksum)
+dht_decode_result_t dht_decode(const dht_pulse_t *pulses, size_t total_pulses, uint8_t data[DHT_DECODE_DATA_BYTES]);
+
+// Name of a decode result, for logs
+const char *dht_decode_result_name(dht_decode_result_t result);
@@ -0,0 +1,283 @@
+#include "dht_rmt.h"
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/rmt_rx.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "dht_decode.h"
+
+static const char *TAG = "DHT_RMT";
+
+#define DHT_RMT_START_US 20000             // Start pulse, DHT11 needs at least 18 ms
+#define DHT_RMT_SI7021_START_US 500
+#define DHT_RMT_MAX_PULSES (DHT_RMT_MEM_SYMBOLS * 2)
+
+typedef enum {
+    DHT_RMT_IDLE,
+    DHT_RMT_START_PULSE,    // Line held low, the start timer is running
+    DHT_RMT_RECEIVING,      // Line released, the RMT channel is capturing the reply
+    DHT_RMT_DONE,           // Capture finished or failed, waiting for dht_rmt_finish_read()
+} dht_rmt_state_t;
+
+typedef struct {
+    gpio_num_t pin;
+    dht_sensor_type_t sensor_type;
+    rmt_channel_handle_t channel;
+    esp_timer_handle_t start_timer;
+    TaskHandle_t task;                  // Notified when the read is done
+    volatile dht_rmt_state_t state;
+    esp_err_t result;
+    size_t total_symbols;
+    rmt_symbol_word_t symbols[DHT_RMT_MEM_SYMBOLS];
+} dht_rmt_sensor_t;
+
+static dht_rmt_sensor_t sensors[DHT_RMT_MAX_SENSORS];
+static uint8_t total_sensors = 0;
+
+// RMT receive done - runs in the ISR, hands the capture to the reading task
+static bool dht_rmt_on_recv_done(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *user_data)
+{
+    dht_rmt_sensor_t *sensor = (dht_rmt_sensor_t *)user_data;
+    BaseType_t woken = pdFALSE;
+    sensor->total_symbols = edata->num_symbols;
+    sensor->state = DHT_RMT_DONE;
+    vTaskNotifyGiveFromISR(sensor->task, &woken);
+    return woken == pdTRUE;
+}
+
+// End of the start pulse - runs in the esp_timer task. The capture is armed before the line is
+// released because the sensor answers 20-40 us later.
+static void dht_rmt_on_start_timer(void *arg)
+{
+    dht_rmt_sensor_t *sensor = (dht_rmt_sensor_t *)arg;
+    rmt_receive_config_t receive_config = {
+        .signal_range_min_ns = DHT_RMT_GLITCH_NS,
+        .signal_range_max_ns = DHT_RMT_IDLE_NS,
+    };
+
+    sensor->state = DHT_RMT_RECEIVING;
+    esp_err_t result = rmt_receive(sensor->channel, sensor->symbols, sizeof(sensor->symbols), &receive_config);
+    gpio_set_level(sensor->pin, 1);
+    if (result != ESP_OK) {
+        sensor->result = result;
+        sensor->state = DHT_RMT_DONE;
+        xTaskNotifyGive(sensor->task);
+    }
+}
+
+static esp_err_t dht_rmt_sensor_init(dht_rmt_sensor_t *sensor, gpio_num_t pin)
+{
+    rmt_rx_channel_config_t config = {
+        .gpio_num = pin,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = DHT_RMT_RESOLUTION_HZ,
+        .mem_block_symbols = DHT_RMT_MEM_SYMBOLS,
+    };
+    esp_err_t result = rmt_new_rx_channel(&config, &sensor->channel);
+    if (result != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create RMT channel on GPIO %d", pin);
+        return result;
+    }
+
+    rmt_rx_event_callbacks_t callbacks = {
+        .on_recv_done = dht_rmt_on_recv_done,
+    };
+    esp_timer_create_args_t timer_args = {
+        .callback = dht_rmt_on_start_timer,
+        .arg = sensor,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "dht_start",
+    };
+    sensor->start_timer = NULL;
+    result = rmt_rx_register_event_callbacks(sensor->channel, &callbacks, sensor);
+    if (result == ESP_OK) {
+        result = esp_timer_create(&timer_args, &sensor->start_timer);
+    }
+    if (result == ESP_OK) {
+        result = rmt_enable(sensor->channel);
+    }
+    if (result != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up RMT channel on GPIO %d", pin);
+        if (sensor->start_timer != NULL) {
+            esp_timer_delete(sensor->start_timer);
+        }
+        rmt_del_channel(sensor->channel);
+        return result;
+    }
+
+    // The RMT channel keeps the pin's input, the open-drain output drives the start pulse
+    gpio_set_direction(pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode(pin, GPIO_PULLUP_ONLY);
+    gpio_set_level(pin, 1);
+    sensor->pin = pin;
+    sensor->state = DHT_RMT_IDLE;
+    return ESP_OK;
+}
+
+static dht_rmt_sensor_t *dht_rmt_find_sensor(gpio_num_t pin)
+{
+    for (uint8_t i = 0; i < total_sensors; i++) {
+        if (sensors[i].pin == pin) {
+            return &sensors[i];
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t dht_rmt_get_sensor(gpio_num_t pin, dht_rmt_sensor_t **sensor)
+{
+    *sensor = dht_rmt_find_sensor(pin);
+    if (*sensor != NULL) {
+        return ESP_OK;
+    }
+    if (total_sensors == DHT_RMT_MAX_SENSORS) {
+        ESP_LOGE(TAG, "No RMT sensor slot left for GPIO %d", pin);
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t result = dht_rmt_sensor_init(&sensors[total_sensors], pin);
+    if (result == ESP_OK) {
+        *sensor = &sensors[total_sensors++];
+    }
+    return result;
+}
+
+// Decode the captured symbols with the pure decoder
+static esp_err_t dht_rmt_decode(const rmt_symbol_word_t *symbols, size_t total_symbols, uint8_t data[DHT_DECODE_DATA_BYTES])
+{
+    dht_pulse_t pulses[DHT_RMT_MAX_PULSES];
+    size_t total_pulses = 0;
+    for (size_t i = 0; i < total_symbols && i < DHT_RMT_MEM_SYMBOLS; i++) {
+        pulses[total_pulses++] = (dht_pulse_t){ .level = symbols[i].level0, .duration_us = symbols[i].duration0 };
+        pulses[total_pulses++] = (dht_pulse_t){ .level = symbols[i].level1, .duration_us = symbols[i].duration1 };
+    }
+
+    switch (dht_decode(pulses, total_pulses, data)) {
+        case DHT_DECODE_OK:
+            return ESP_OK;
+        case DHT_DECODE_NO_RESPONSE:
+            return ESP_ERR_TIMEOUT;
+        case DHT_DECODE_CHECKSUM:
+            return ESP_ERR_INVALID_CRC;
+        default:
+            return ESP_ERR_INVALID_RESPONSE;
+    }
+}
+
+static int16_t dht_rmt_convert(dht_sensor_type_t sensor_type, uint8_t msb, uint8_t lsb)
+{
+    if (sensor_type == DHT_TYPE_DHT11) {
+        return msb * 10;
+    }
+    int16_t value = (msb & 0x7F) << 8 | lsb;
+    return msb & 0x80 ? -value : value;
+}
+
+esp_err_t dht_rmt_start_read(dht_sensor_type_t sensor_type, gpio_num_t pin, TaskHandle_t task)
+{
+    dht_rmt_sensor_t *sensor;
+    esp_err_t result = dht_rmt_get_sensor(pin, &sensor);
+    if (result != ESP_OK) {
+        return result;
+    }
+    if (sensor->state == DHT_RMT_START_PULSE || sensor->state == DHT_RMT_RECEIVING) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    sensor->sensor_type = sensor_type;
+    sensor->task = task;
+    sensor->result = ESP_OK;
+    sensor->state = DHT_RMT_START_PULSE;
+
+    // The start pulse is timed by esp_timer, interrupts stay enabled and the caller can block
+    gpio_set_level(pin, 0);
+    result = esp_timer_start_once(sensor->start_timer,
+                                  sensor_type == DHT_TYPE_SI7021 ? DHT_RMT_SI7021_START_US : DHT_RMT_START_US);
+    if (result != ESP_OK) {
+        gpio_set_level(pin, 1);
+        sensor->state = DHT_RMT_IDLE;
+    }
+    return result;
+}
+
+esp_err_t dht_rmt_finish_read(gpio_num_t pin, int16_t *humidity, int16_t *temperature)
+{
+    dht_rmt_sensor_t *sensor = dht_rmt_find_sensor(pin);
+    if (sensor == NULL || sensor->state == DHT_RMT_IDLE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (sensor->state != DHT_RMT_DONE) {
+        // Cancel the read - stop the start pulse or the capture that never ended
+        esp_timer_stop(sensor->start_timer);
+        gpio_set_level(pin, 1);
+        rmt_disable(sensor->channel);
+        rmt_enable(sensor->channel);
+        sensor->state = DHT_RMT_IDLE;
+        if (sensor->task == xTaskGetCurrentTaskHandle()) {
+            ulTaskNotifyTake(pdTRUE, 0);
+        }
+        return ESP_ERR_TIMEOUT;
+    }
+
+    sensor->state = DHT_RMT_IDLE;
+    if (sensor->result != ESP_OK) {
+        return sensor->result;
+    }
+
+    uint8_t data[DHT_DECODE_DATA_BYTES];
+    esp_err_t result = dht_rmt_decode(sensor->symbols, sensor->total_symbols, data);
+    if (result != ESP_OK) {
+        return result;
+    }
+
+    if (humidity) {
+        *humidity = dht_rmt_convert(sensor->sensor_type, data[0], data[1]);
+    }
+    if (temperature) {
+        *temperature = dht_rmt_convert(sensor->sensor_type, data[2], data[3]);
+    }
+    return ESP_OK;
+}
+
+esp_err_t dht_rmt_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
+                            int16_t *humidity, int16_t *temperature)
+{
+    if (!humidity && !temperature) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t result = dht_rmt_start_read(sensor_type, pin, xTaskGetCurrentTaskHandle());
+    if (result != ESP_OK) {
+        return result;
+    }
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DHT_RMT_READ_TIMEOUT_MS));
+    return dht_rmt_finish_read(pin, humidity, temperature);
+}
+
+esp_err_t dht_rmt_read_float_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
+                                  float *humidity, float *temperature)
+{
+    if (!humidity && !temperature) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int16_t raw_humidity, raw_temperature;
+    esp_err_t result = dht_rmt_read_data(sensor_type, pin,
+                                         humidity ? &raw_humidity : NULL,
+                                         temperature ? &raw_temperature : NULL);
+    if (result != ESP_OK) {
+        return result;
+    }
+
+    if (humidity) {
+        *humidity = raw_humidity / 10.0f;
+    }
+    if (temperature) {
+        *temperature = raw_temperature / 10.0f;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "dht.h"
+
+// DHT backend on the RMT peripheral. The start pulse is timed by esp_timer and the sensor's reply
+// is captured by an RMT receive channel and decoded afterwards, so interrupts stay enabled for the
+// whole transaction and the reading task stays blocked. Same sensors, units and results as the
+// dht component.
+
+#define DHT_RMT_MAX_SENSORS 8              // Distinct pins that can be read, one RMT channel each
+#define DHT_RMT_RESOLUTION_HZ 1000000      // 1 us per RMT tick
+#define DHT_RMT_MEM_SYMBOLS 64             // One frame is about 43 symbols
+#define DHT_RMT_GLITCH_NS 1000             // Pulses shorter than this are noise
+#define DHT_RMT_IDLE_NS 200000             // A level held this long ends the frame
+#define DHT_RMT_READ_TIMEOUT_MS 100        // Start pulse plus a frame of at most about 5 ms
+
+// Start a read without waiting for it. The task is notified (xTaskNotifyGive) once the reply is
+// captured or the read failed; then call dht_rmt_finish_read(). Returns ESP_ERR_INVALID_STATE
+// if a read of the same pin is already in progress.
+esp_err_t dht_rmt_start_read(dht_sensor_type_t sensor_type, gpio_num_t pin, TaskHandle_t task);
+
+// Decode a read started with dht_rmt_start_read(), results like dht_rmt_read_data(). A read that
+// is not done yet - no notification within DHT_RMT_READ_TIMEOUT_MS - is cancelled and returns
+// ESP_ERR_TIMEOUT.
+esp_err_t dht_rmt_finish_read(gpio_num_t pin, int16_t *humidity, int16_t *temperature);
+
+// Same as dht_read_data(): humidity and temperature in tenths, either nullable but not both
+// (ESP_ERR_INVALID_ARG).
+// Blocks on the calling task's notification until the read is done.
+esp_err_t dht_rmt_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
+                            int16_t *humidity, int16_t *temperature);
+
+// Same as dht_read_float_data(): humidity in percent and temperature in degrees Celsius, either
+// nullable but not both (ESP_ERR_INVALID_ARG).
+// Returns ESP_ERR_TIMEOUT if the sensor does not answer, ESP_ERR_INVALID_RESPONSE if the frame is
+// incomplete, ESP_ERR_INVALID_CRC on a checksum mismatch, or the RMT error if the channel fails.
+// The RMT channel of a pin is created on its first read; a pin must only be read from one task.
+esp_err_t dht_rmt_read_float_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
+                                  float *humidity, float *temperature);
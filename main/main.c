@@ -1,32 +1,78 @@
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "driver/gpio.h"
 #include "driver/i2c_master.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "dht.h"
+#include "sensor_scheduler.h"
+#include "sensor_filter.h"
+#include "deci.h"
+#include "num_format.h"
+#include "relay.h"
+#include "pid_control.h"
+#include "pid_autotune.h"
 #include "ssd1306.h"
 #include "translations.h"
+#include "ui_widget.h"
+#include "deferred_log.h"
 
 static const char *TAG = "ESP32_AIRZONE";
 
 // GPIO Configuration for ESP32 DEVKITV1
-#define DHT11_GPIO GPIO_NUM_4
+#define DHT11_GPIO GPIO_NUM_4             // Zone 1 sensor
 #define BUTTON_WHITE_GPIO GPIO_NUM_5      // White button - MODE (External)
 #define BUTTON_BLUE_GPIO GPIO_NUM_18      // Blue button - DECREASE temperature (External)
 #define BUTTON_RED_GPIO GPIO_NUM_19       // Red button - INCREASE temperature (External)
-#define COOLING_GPIO GPIO_NUM_13          // Cooling relay output
-#define HEATING_GPIO GPIO_NUM_14          // Heating relay output
+#define COOLING_GPIO GPIO_NUM_13          // Zone 1 cooling relay output
+#define HEATING_GPIO GPIO_NUM_14          // Zone 1 heating relay output
 
 // Temperature control parameters
-#define TEMP_CHECK_INTERVAL_MS 2000    // Check temperature every 2 seconds
-#define TEMP_MARGIN 1.0                // Temperature margin in Celsius
-#define TEMP_STEP 0.5                  // Temperature adjustment step
-#define MIN_TEMP 16.0                  // Minimum set temperature
-#define MAX_TEMP 35.0                  // Maximum set temperature
-#define DEFAULT_TEMP 22.0              // Default set temperature
+#define TEMP_CHECK_INTERVAL_MS 2000    // Fastest sampling, while a zone is being controlled
+#define TEMP_MARGIN DECI(1.0)          // Hysteresis band in Celsius - on beyond setpoint ± margin, off back at the setpoint
+#define TEMP_STEP DECI(0.5)            // Temperature adjustment step
+#define MIN_TEMP DECI(16.0)            // Minimum set temperature
+#define MAX_TEMP DECI(35.0)            // Maximum set temperature
+#define DEFAULT_TEMP DECI(22.0)        // Default set temperature
+
+// Compressor protection - a relay runs at least RELAY_MIN_ON_MS and rests at least RELAY_MIN_OFF_MS,
+// including after boot, so a noisy reading can never short-cycle it
+#define RELAY_MIN_ON_MS 180000         // Minimum run time, 3 minutes
+#define RELAY_MIN_OFF_MS 300000        // Minimum off time, 5 minutes
+
+// PID control - zones with .control = CONTROL_PID drive their relay by slow PWM from a PI controller.
+// A mode whose gains are left at zero is autotuned the first time it runs, and the gains are logged
+// so they can be copied into the zone table.
+#define PID_SAMPLE_MS 30000            // Controller period
+#define PID_PWM_WINDOW_MS 1200000      // Slow PWM window, 20 minutes
+#define PID_AUTOTUNE_HYSTERESIS DECI(0.2) // Relay hysteresis while autotuning, above the filtered sensor noise
+
+// Adaptive sampling - fast while a relay is on or the temperature moves or nears the setpoint margin,
+// backing off by doubling the period up to SAMPLE_SLOW_MS when the zone is OFF or stable
+#define SAMPLE_SLOW_MS 60000           // Slowest sampling
+#define SAMPLE_NEAR_SETPOINT DECI(1.0) // Sample fast within this distance of the setpoint margin
+#define SAMPLE_MOVING_DELTA DECI(0.2)  // A change this big between readings is movement
+#define SAMPLE_STABLE_READINGS 3       // Quiet readings before backing off
+
+// Sensor health - stale-data fail-safe and the thresholds used to tell a dead sensor from flaky wiring
+#define SENSOR_STALE_MS 180000         // Relays OFF once a zone's temperature is older than this
+#define SENSOR_DEAD_FAILURES 5         // Consecutive failures of a sensor considered dead
+#define SENSOR_FLAKY_PERCENT 5         // CRC and frame errors above this share of reads mean flaky wiring
+
+// Statistics
+#define STATS_REPORT_INTERVAL_MS 600000 // Log sample rate, sensor health and relay duty every 10 minutes
+
+// Display parameters
+#define DISPLAY_STATS_INTERVAL 60      // Log display I2C traffic every 60 updates
+#define DISPLAY_MIN_FRAME_MS 50        // Frame-rate cap, at most 20 frames per second
+#define DISPLAY_KEEPALIVE_MS 30000     // Resend the whole frame after 30 seconds without changes
+#define DISPLAY_SPLASH_MS 2000         // Longest time the welcome message is shown
+#define DISPLAY_SPLASH_MIN_MS 1000     // Shortest time the welcome message is shown, so it can be read
 
 // Thermostat modes
 typedef enum {
@@ -35,14 +81,66 @@ typedef enum {
     MODE_HEAT = 2
 } thermostat_mode_t;
 
+// Control types
+typedef enum {
+    CONTROL_ON_OFF = 0,     // Hysteresis around the setpoint
+    CONTROL_PID = 1         // PI controller and slow PWM
+} control_type_t;
+
+// Zone - one sensor, one pair of relays and one setpoint
+typedef struct {
+    const char *name;
+    dht_sensor_type_t sensor_type;
+    gpio_num_t sensor_gpio;
+    gpio_num_t cooling_gpio;
+    gpio_num_t heating_gpio;
+    deci_t current_temperature;
+    deci_t current_humidity;
+    deci_t set_temperature;
+    thermostat_mode_t mode;
+    relay_t cooling_relay;
+    relay_t heating_relay;
+    control_type_t control;
+    pid_gains_t cooling_gains;                 // CONTROL_PID gains per mode, autotuned while zero
+    pid_gains_t heating_gains;
+    thermostat_mode_t pid_mode;                // Mode the controller state below belongs to, MODE_OFF to restart
+    pid_controller_t pid;
+    slow_pwm_t pwm;
+    int64_t pid_updated_us;                    // Time of the last controller step, 0 before the first
+    pid_autotune_t autotune;
+    bool autotuning;
+    bool reading_valid;                        // Set once the zone's first sensor reading arrives
+    int64_t last_update_us;                    // esp_timer time of the last temperature used
+    bool sensor_stale;                         // No usable temperature for SENSOR_STALE_MS, relays held OFF
+    uint32_t sample_period_ms;                 // Current sensor period, see adapt_sample_period()
+    uint8_t stable_readings;                   // Consecutive readings with nothing to control
+    sensor_filter_t temperature_filter;        // Raw readings pass through these before they are used
+    sensor_filter_t humidity_filter;
+} zone_t;
+
+// Zone table - add a row per zone, up to SENSOR_SCHEDULER_MAX_SENSORS
+static zone_t zones[] = {
+    { .name = "Zone 1", .sensor_type = DHT_TYPE_DHT11, .sensor_gpio = DHT11_GPIO,
+      .cooling_gpio = COOLING_GPIO, .heating_gpio = HEATING_GPIO,
+      .set_temperature = DEFAULT_TEMP, .mode = MODE_OFF, .control = CONTROL_ON_OFF },
+};
+#define ZONE_COUNT (sizeof(zones) / sizeof(zones[0]))
+_Static_assert(ZONE_COUNT <= SENSOR_SCHEDULER_MAX_SENSORS, "Too many zones for the sensor scheduler");
+// A reject drops sampling back to fast, so the rate gate holds a real new level for at most one slow
+// period plus its fast rejects - it alone must never make the zone stale
+_Static_assert(SAMPLE_SLOW_MS + SENSOR_FILTER_MAX_REJECTS * TEMP_CHECK_INTERVAL_MS < SENSOR_STALE_MS,
+               "The sensor filter rate gate can outlast the stale timeout");
+
+// last_update_us is written by the sensor task and read by the control task, a 64-bit value can tear
+static portMUX_TYPE zone_update_lock = portMUX_INITIALIZER_UNLOCKED;
+// sample_period_ms and stable_readings are checked and set by the sensor and button tasks. A mutex,
+// not a spinlock, since sensor_scheduler_set_period() may give a semaphore while it is held
+static SemaphoreHandle_t sample_period_lock = NULL;
+
 // Global variables
-static float current_temperature = 0.0f;
-static float current_humidity = 0.0f;
-static float set_temperature = DEFAULT_TEMP;
-static thermostat_mode_t current_mode = MODE_OFF;
-static bool cooling_active = false;
-static bool heating_active = false;
+static uint8_t selected_zone = 0;              // Zone shown on the display and adjusted by the buttons
 static QueueHandle_t button_queue = NULL;
+static TaskHandle_t display_task_handle = NULL;
 
 // Button debouncing variables
 static uint32_t last_button_time[3] = {0, 0, 0}; // Track each button separately
@@ -56,45 +154,68 @@ typedef struct {
 
 // Function prototypes
 static void button_task(void *pvParameter);
-static void temperature_task(void *pvParameter);
+static void on_sensor_reading(uint8_t sensor, esp_err_t result, deci_t humidity, deci_t temperature);
 static void control_task(void *pvParameter);
 static void display_task(void *pvParameter);
 static void gpio_isr_handler(void *arg);
 static void update_display(void);
+static void notify_display(void);
+static void log_display_stats(void);
+static void log_boot_phase(const char *phase);
+static void log_sensor_stats(void);
+static void log_relay_stats(void);
+static const char *sensor_health_verdict(const sensor_scheduler_stats_t *stats);
+static void check_sensor_stale(size_t zone_index);
+static void adapt_sample_period(zone_t *zone, deci_t previous_temperature);
+static void set_sample_period(zone_t *zone, uint32_t period_ms);
+static void sample_fast(zone_t *zone);
 static void process_button_event(button_event_t event);
-static void update_control_outputs(void);
+static void update_control_outputs(zone_t *zone);
+static bool on_off_demand(const zone_t *zone, const relay_t *relay);
+static bool pid_demand(zone_t *zone, const relay_t *relay, int64_t now_us);
 static int get_button_index(uint32_t gpio_num);
+static void format_temperature(char *text, size_t size, int32_t value);
+static void format_setpoint(char *text, size_t size, int32_t value);
+static void format_humidity(char *text, size_t size, int32_t value);
+static void format_mode_label(char *text, size_t size, int32_t value);
+static void format_mode(char *text, size_t size, int32_t value);
+
+// Display layout - each widget redraws only its own rectangle when its value changes
+// Temperatures and humidity are bound in tenths (deci_t) so the widgets compare integers
+// The current temperature is drawn in 3x digits at the top so it can be read from across the room
+static ui_widget_t temperature_widget = { .name = "temperature", .x = 0, .y = 0, .width = 128, .height = 24, .scale = 3, .format = format_temperature };
+static ui_widget_t humidity_widget = { .name = "humidity", .x = 0, .y = 28, .width = 64, .height = 8, .format = format_humidity };
+static ui_widget_t setpoint_widget = { .name = "setpoint", .x = 64, .y = 28, .width = 64, .height = 8, .format = format_setpoint };
+static ui_widget_t mode_label_widget = { .name = "mode_label", .x = 0, .y = 42, .width = 128, .height = 8, .format = format_mode_label };
+static ui_widget_t mode_widget = { .name = "mode", .x = 0, .y = 52, .width = 128, .height = 8, .format = format_mode };
 
 void app_main(void)
 {
     ESP_LOGI(TAG, "Starting ESP32 Airzone TACTO Replacement");
 
-    // Set language (change this to LANG_SPANISH for Spanish)
-    set_language(LANG_SPANISH);
-    
-    // Get translations
-    const translations_t* t = get_translations();
-
-    // Initialize SSD1306 display
-    init_ssd1306();
-    ESP_LOGI(TAG, "SSD1306 display initialized");
-
-    // Show initial welcome message
-    ssd1306_print_str(18, 0, t->esp32_airzone, false);
-    ssd1306_print_str(28, 17, t->thermostat, false);
-    ssd1306_print_str(38, 27, t->starting, false);
-    ssd1306_display();
-    vTaskDelay(2000 / portTICK_PERIOD_MS);
-
-    // Initialize GPIO pins
+    // Drive the relays to their OFF level before anything else, the level is latched before the pins become outputs
+    uint64_t relay_mask = 0;
+    int64_t now_us = esp_timer_get_time();
+    for (size_t i = 0; i < ZONE_COUNT; i++) {
+        relay_init(&zones[i].cooling_relay, zones[i].cooling_gpio, RELAY_MIN_ON_MS, RELAY_MIN_OFF_MS, now_us);
+        relay_init(&zones[i].heating_relay, zones[i].heating_gpio, RELAY_MIN_ON_MS, RELAY_MIN_OFF_MS, now_us);
+        relay_mask |= (1ULL << zones[i].cooling_gpio) | (1ULL << zones[i].heating_gpio);
+    }
     gpio_config_t io_conf = {
         .intr_type = GPIO_INTR_DISABLE,
         .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = (1ULL << COOLING_GPIO) | (1ULL << HEATING_GPIO),
+        .pin_bit_mask = relay_mask,
         .pull_down_en = 0,
         .pull_up_en = 0,
     };
     gpio_config(&io_conf);
+    log_boot_phase("relays OFF");
+
+    // Hot paths log through the deferred log so they never wait on the UART
+    deferred_log_start();
+
+    // Set language (change this to LANG_SPANISH for Spanish)
+    set_language(LANG_SPANISH);
 
     // Configure button GPIOs
     io_conf.intr_type = GPIO_INTR_NEGEDGE;
@@ -103,8 +224,9 @@ void app_main(void)
     io_conf.pull_up_en = 1;
     gpio_config(&io_conf);
 
-    // Create button queue
+    // Create button queue and the sampling period lock
     button_queue = xQueueCreate(10, sizeof(button_event_t));
+    sample_period_lock = xSemaphoreCreateMutex();
 
     // Install GPIO ISR service
     gpio_install_isr_service(0);
@@ -114,18 +236,24 @@ void app_main(void)
     gpio_isr_handler_add(BUTTON_BLUE_GPIO, gpio_isr_handler, (void*)BUTTON_BLUE_GPIO);
     gpio_isr_handler_add(BUTTON_RED_GPIO, gpio_isr_handler, (void*)BUTTON_RED_GPIO);
 
-    ESP_LOGI(TAG, "Starting DHT11 sensor on GPIO %d", DHT11_GPIO);
-
-    // Put relays in OFF state
-    gpio_set_level(COOLING_GPIO, 1);
-    gpio_set_level(HEATING_GPIO, 1);
+    // One scheduler reads every zone sensor, staggered so two reads never run back to back
+    sensor_scheduler_sensor_t sensors[ZONE_COUNT];
+    for (size_t i = 0; i < ZONE_COUNT; i++) {
+        zones[i].sample_period_ms = TEMP_CHECK_INTERVAL_MS;
+        sensors[i] = (sensor_scheduler_sensor_t){ .type = zones[i].sensor_type, .gpio = zones[i].sensor_gpio,
+                                                  .period_ms = TEMP_CHECK_INTERVAL_MS };
+        ESP_LOGI(TAG, "%s: sensor on GPIO %d, relays on GPIO %d and %d", zones[i].name,
+                 zones[i].sensor_gpio, zones[i].cooling_gpio, zones[i].heating_gpio);
+    }
 
-    // Create tasks
+    // Create tasks - the display task brings up the display and shows the splash screens
+    // while the sensors are already being read
     xTaskCreate(button_task, "button_task", 2048, NULL, 5, NULL);
-    xTaskCreate(temperature_task, "temp_task", 2048, NULL, 4, NULL);
+    sensor_scheduler_start(sensors, ZONE_COUNT, on_sensor_reading);
     xTaskCreate(control_task, "control_task", 2048, NULL, 3, NULL);
-    xTaskCreate(display_task, "display_task", 2048, NULL, 2, NULL);
+    xTaskCreate(display_task, "display_task", 3072, NULL, 2, &display_task_handle);
 
+    log_boot_phase("tasks started");
     ESP_LOGI(TAG, "All tasks started successfully");
 }
 
@@ -141,44 +269,295 @@ static void button_task(void *pvParameter)
     }
 }
 
-// Temperature reading task
-static void temperature_task(void *pvParameter)
+// Sensor reading - called from the sensor scheduler task, sensor indexes match the zone table
+static void on_sensor_reading(uint8_t sensor, esp_err_t result, deci_t humidity, deci_t temperature)
 {
-    while (1) {
-        float humidity = 0.0f;
-        float temperature = 0.0f;
-        esp_err_t result = dht_read_float_data(DHT_TYPE_DHT11, DHT11_GPIO, &humidity, &temperature);
-        
-        if (result == ESP_OK) {
-            current_temperature = temperature;
-            current_humidity = humidity;
-            ESP_LOGI(TAG, "Temperature: %.2f°C, Humidity: %.2f%%", temperature, humidity);
+    zone_t *zone = &zones[sensor];
+
+    if (result == ESP_OK) {
+        // A value the rate gate rejects is dropped, the zone keeps its last filtered one
+        deci_t filtered;
+        if (sensor_filter_update(&zone->humidity_filter, humidity, &filtered)) {
+            zone->current_humidity = filtered;
         } else {
-            ESP_LOGE(TAG, "Failed to read DHT11 sensor, error: %s", esp_err_to_name(result));
+            DLOGW(TAG, "%s: Humidity outlier rejected: %d", zone->name, humidity);
+        }
+        if (!sensor_filter_update(&zone->temperature_filter, temperature, &filtered)) {
+            DLOGW(TAG, "%s: Temperature outlier rejected: %d", zone->name, temperature);
+            // Confirm or drop the outlier at the fast rate instead of waiting out slow periods
+            sample_fast(zone);
+            return;
+        }
+        deci_t previous_temperature = zone->reading_valid ? zone->current_temperature : filtered;
+        zone->current_temperature = filtered;
+        portENTER_CRITICAL(&zone_update_lock);
+        zone->last_update_us = esp_timer_get_time();
+        portEXIT_CRITICAL(&zone_update_lock);
+        adapt_sample_period(zone, previous_temperature);
+        if (!zone->reading_valid) {
+            zone->reading_valid = true;
+            log_boot_phase("first valid reading");
+        }
+        if (sensor == selected_zone) {
+            notify_display();
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(TEMP_CHECK_INTERVAL_MS));
+        DLOGI(TAG, "%s: Temperature: %d, Humidity: %d (tenths of °C and %%)", zone->name, zone->current_temperature, zone->current_humidity);
+    } else {
+        DLOGE(TAG, "%s: Failed to read sensor, error: %s", zone->name, esp_err_to_name(result));
     }
 }
 
+// Pick a zone's sampling period from its latest reading - fast while there is something to control,
+// backing off after SAMPLE_STABLE_READINGS quiet readings
+static void adapt_sample_period(zone_t *zone, deci_t previous_temperature)
+{
+    int distance = abs(zone->current_temperature - zone->set_temperature);
+    bool active = zone->mode != MODE_OFF &&
+                  (zone->cooling_relay.on || zone->heating_relay.on ||
+                   distance <= TEMP_MARGIN + SAMPLE_NEAR_SETPOINT ||
+                   abs(zone->current_temperature - previous_temperature) >= SAMPLE_MOVING_DELTA);
+
+    if (active) {
+        sample_fast(zone);
+        return;
+    }
+    xSemaphoreTake(sample_period_lock, portMAX_DELAY);
+    if (zone->stable_readings < SAMPLE_STABLE_READINGS) {
+        zone->stable_readings++;
+    } else {
+        uint32_t period_ms = zone->sample_period_ms * 2;
+        set_sample_period(zone, period_ms < SAMPLE_SLOW_MS ? period_ms : SAMPLE_SLOW_MS);
+    }
+    xSemaphoreGive(sample_period_lock);
+}
+
+// Drop a zone back to the fast sampling rate and restart its count of quiet readings
+static void sample_fast(zone_t *zone)
+{
+    xSemaphoreTake(sample_period_lock, portMAX_DELAY);
+    zone->stable_readings = 0;
+    set_sample_period(zone, TEMP_CHECK_INTERVAL_MS);
+    xSemaphoreGive(sample_period_lock);
+}
+
+// Called with sample_period_lock held, so the cached period always matches the scheduler's
+static void set_sample_period(zone_t *zone, uint32_t period_ms)
+{
+    if (zone->sample_period_ms == period_ms) {
+        return;
+    }
+    zone->sample_period_ms = period_ms;
+    sensor_scheduler_set_period(zone - zones, period_ms);
+    DLOGI(TAG, "%s: Sampling every %lu ms", zone->name, period_ms);
+}
+
 // Control logic task
 static void control_task(void *pvParameter)
 {
+    bool control_started = false;
+    int64_t last_report_us = esp_timer_get_time();
+
     while (1) {
-        update_control_outputs();
+        for (size_t i = 0; i < ZONE_COUNT; i++) {
+            check_sensor_stale(i);
+            // Keep a zone's relays OFF until there is a temperature to control
+            if (!zones[i].reading_valid) {
+                continue;
+            }
+            if (!control_started) {
+                control_started = true;
+                log_boot_phase("control started");
+            }
+            update_control_outputs(&zones[i]);
+        }
+
+        if (esp_timer_get_time() - last_report_us >= (int64_t)STATS_REPORT_INTERVAL_MS * 1000) {
+            last_report_us = esp_timer_get_time();
+            log_sensor_stats();
+            log_relay_stats();
+        }
         vTaskDelay(pdMS_TO_TICKS(1000)); // Check every second
     }
 }
 
-// Display update task
+// Display update task - renders when notified of a state change
 static void display_task(void *pvParameter)
 {
+    uint32_t updates = 0;
+    const translations_t* t = get_translations();
+
+    // Initialize SSD1306 display
+    init_ssd1306();
+    ESP_LOGI(TAG, "SSD1306 display initialized");
+    log_boot_phase("display ready");
+
+    // Show initial welcome message until the splash time is over or there is something to show.
+    // Notifications sent before the display was up are dropped, the first frame after the splash draws
+    // everything anyway; a reading during the minimum time ends the splash right after it.
+    ulTaskNotifyTake(pdTRUE, 0);
+    ssd1306_begin_frame();
+    ssd1306_print_str(18, 0, t->esp32_airzone, false);
+    ssd1306_print_str(28, 17, t->thermostat, false);
+    ssd1306_print_str(38, 27, t->starting, false);
+    ssd1306_display();
+    vTaskDelay(pdMS_TO_TICKS(DISPLAY_SPLASH_MIN_MS));
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DISPLAY_SPLASH_MS - DISPLAY_SPLASH_MIN_MS));
+
+    // Remove the welcome message, the widgets only clear their own rectangles
+    ssd1306_begin_frame();
+    ssd1306_clear();
+    ssd1306_end_frame();
+    update_display();
+    TickType_t last_frame = xTaskGetTickCount();
+
     while (1) {
+        // Idle periods produce no frames except the keep-alive, which resends the whole frame
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DISPLAY_KEEPALIVE_MS)) == 0) {
+            ssd1306_invalidate();
+            ssd1306_begin_frame();
+            ssd1306_display();
+            continue;
+        }
+
+        // Cap the frame rate, changes notified while waiting are folded into this frame
+        TickType_t elapsed = xTaskGetTickCount() - last_frame;
+        if (elapsed < pdMS_TO_TICKS(DISPLAY_MIN_FRAME_MS)) {
+            vTaskDelay(pdMS_TO_TICKS(DISPLAY_MIN_FRAME_MS) - elapsed);
+            ulTaskNotifyTake(pdTRUE, 0);
+        }
+
         update_display();
-        vTaskDelay(pdMS_TO_TICKS(1000)); // Update every second
+        last_frame = xTaskGetTickCount();
+
+        if (++updates % DISPLAY_STATS_INTERVAL == 0) {
+            log_display_stats();
+        }
+    }
+}
+
+// Wake the display task after a change in the displayed state
+static void notify_display(void)
+{
+    if (display_task_handle != NULL) {
+        xTaskNotifyGive(display_task_handle);
     }
 }
 
+// Log the time since boot at which a boot phase completed
+static void log_boot_phase(const char *phase)
+{
+    ESP_LOGI(TAG, "Boot: %s at %lld ms", phase, esp_timer_get_time() / 1000);
+}
+
+// Flag a zone whose temperature is too old - the control loop then fails safe with its relays OFF
+static void check_sensor_stale(size_t zone_index)
+{
+    zone_t *zone = &zones[zone_index];
+    portENTER_CRITICAL(&zone_update_lock);
+    int64_t last_update_us = zone->last_update_us;
+    portEXIT_CRITICAL(&zone_update_lock);
+    bool stale = esp_timer_get_time() - last_update_us > (int64_t)SENSOR_STALE_MS * 1000;
+    if (stale == zone->sensor_stale) {
+        return;
+    }
+
+    zone->sensor_stale = stale;
+    if (stale) {
+        sensor_scheduler_stats_t stats = { 0 };
+        sensor_scheduler_get_stats(zone_index, &stats);
+        ESP_LOGW(TAG, "%s: No temperature for %d s, relays OFF. Sensor: %s", zone->name,
+                 SENSOR_STALE_MS / 1000, sensor_health_verdict(&stats));
+    } else {
+        ESP_LOGI(TAG, "%s: Sensor readings resumed", zone->name);
+    }
+    if (zone_index == selected_zone) {
+        notify_display();
+    }
+}
+
+// Tell a dead or disconnected sensor from flaky wiring by how its reads fail
+static const char *sensor_health_verdict(const sensor_scheduler_stats_t *stats)
+{
+    if (stats->consecutive_failures >= SENSOR_DEAD_FAILURES) {
+        return stats->successes == 0 || stats->timeouts * 2 > stats->reads - stats->successes
+            ? "not answering, dead or disconnected" : "failing";
+    }
+    if ((uint64_t)(stats->crc_errors + stats->other_errors) * 100 > (uint64_t)stats->reads * SENSOR_FLAKY_PERCENT) {
+        return "flaky wiring";
+    }
+    return "ok";
+}
+
+// Log each zone's effective sample rate and sensor duty cycle since the last report, next to the
+// number of reads sampling at the fastest rate would have made, and the sensor health counters
+static void log_sensor_stats(void)
+{
+    static sensor_scheduler_stats_t last_stats[ZONE_COUNT];
+    static int64_t last_us = 0;
+    int64_t now_us = esp_timer_get_time();
+    int64_t elapsed_us = now_us - last_us;
+
+    for (size_t i = 0; i < ZONE_COUNT; i++) {
+        sensor_scheduler_stats_t stats;
+        if (sensor_scheduler_get_stats(i, &stats) != ESP_OK) {
+            continue;
+        }
+        uint32_t reads = stats.reads - last_stats[i].reads;
+        uint32_t busy_per_10000 = (uint32_t)((stats.busy_us - last_stats[i].busy_us) * 10000 / elapsed_us);
+        ESP_LOGI(TAG, "%s: %lu sensor reads in %lld s (%lld at a fixed %d ms), period %lu ms, sensor busy %lu.%02lu%%",
+                 zones[i].name, reads, elapsed_us / 1000000, elapsed_us / (TEMP_CHECK_INTERVAL_MS * 1000LL),
+                 TEMP_CHECK_INTERVAL_MS, stats.period_ms, busy_per_10000 / 100, busy_per_10000 % 100);
+        ESP_LOGI(TAG, "%s: Sensor %s: %lu ok, %lu CRC, %lu timeout, %lu other errors, %lu consecutive failures, last good %lld s ago",
+                 zones[i].name, sensor_health_verdict(&stats), stats.successes, stats.crc_errors, stats.timeouts,
+                 stats.other_errors, stats.consecutive_failures,
+                 stats.last_good_us ? (now_us - stats.last_good_us) / 1000000 : -1);
+        ESP_LOGI(TAG, "%s: Read latency: %lu <24 ms, %lu <26 ms, %lu <30 ms, %lu <50 ms, %lu >=50 ms", zones[i].name,
+                 stats.latency[0], stats.latency[1], stats.latency[2], stats.latency[3], stats.latency[4]);
+        last_stats[i] = stats;
+    }
+    last_us = now_us;
+}
+
+// Log each relay's starts and duty cycle since the last report, to see short-cycling
+static void log_relay_stats(void)
+{
+    static uint32_t last_starts[ZONE_COUNT][2];
+    static uint64_t last_on_us[ZONE_COUNT][2];
+    static int64_t last_us = 0;
+    int64_t now_us = esp_timer_get_time();
+    int64_t elapsed_us = now_us - last_us;
+
+    for (size_t i = 0; i < ZONE_COUNT; i++) {
+        const relay_t *relays[2] = { &zones[i].cooling_relay, &zones[i].heating_relay };
+        static const char *const relay_names[2] = { "Cooling", "Heating" };
+        for (size_t r = 0; r < 2; r++) {
+            uint64_t on_us = relay_on_time_us(relays[r], now_us);
+            uint32_t starts = relays[r]->starts - last_starts[i][r];
+            uint32_t starts_per_10_hours = (uint32_t)(starts * 36000000000LL / elapsed_us);
+            uint32_t duty_per_1000 = (uint32_t)((on_us - last_on_us[i][r]) * 1000 / elapsed_us);
+            ESP_LOGI(TAG, "%s: %s relay: %lu starts, %lu.%lu per hour, duty %lu.%lu%%", zones[i].name, relay_names[r],
+                     starts, starts_per_10_hours / 10, starts_per_10_hours % 10, duty_per_1000 / 10, duty_per_1000 % 10);
+            last_starts[i][r] = relays[r]->starts;
+            last_on_us[i][r] = on_us;
+        }
+    }
+    last_us = now_us;
+}
+
+// Log the display I2C traffic counters
+static void log_display_stats(void)
+{
+    ssd1306_flush_stats_t stats;
+    ssd1306_get_flush_stats(&stats);
+    ESP_LOGI(TAG, "Display I2C: %lu bytes sent, %lu bytes skipped, %lu transactions in %lu flushes",
+             stats.bytes_sent, stats.bytes_skipped, stats.transactions, stats.flushes);
+    ESP_LOGI(TAG, "Display flush latency: last %lu us, max %lu us, avg %lu us",
+             stats.last_flush_us, stats.max_flush_us,
+             stats.flushes ? (uint32_t)(stats.total_flush_us / stats.flushes) : 0);
+    ESP_LOGI(TAG, "Display frames: %lu submitted, %lu coalesced, %lu dropped",
+             stats.frames_submitted, stats.frames_coalesced, stats.frames_dropped);
+}
+
 // GPIO ISR handler
 static void gpio_isr_handler(void *arg)
 {
@@ -199,7 +578,7 @@ static void process_button_event(button_event_t event)
     // Get button index and validate
     int button_index = get_button_index(event.gpio_num);
     if (button_index < 0) {
-        ESP_LOGE(TAG, "Invalid button GPIO: %lu", event.gpio_num);
+        DLOGE(TAG, "Invalid button GPIO: %lu", event.gpio_num);
         return;
     }
     
@@ -208,7 +587,7 @@ static void process_button_event(button_event_t event)
     
     // Check if enough time has passed since last button press
     if (current_time - last_button_time[button_index] < BUTTON_DEBOUNCE_MS) {
-        ESP_LOGI(TAG, "Button press ignored - debouncing (time since last: %lums)", 
+        DLOGI(TAG, "Button press ignored - debouncing (time since last: %lums)", 
                  current_time - last_button_time[button_index]);
         return;
     }
@@ -216,83 +595,193 @@ static void process_button_event(button_event_t event)
     // Update last button time
     last_button_time[button_index] = current_time;
     
+    // A new mode or setpoint is something to control, sample fast again
+    zone_t *zone = &zones[selected_zone];
+    sample_fast(zone);
     switch (event.gpio_num) {
         case BUTTON_WHITE_GPIO:
-            current_mode = (current_mode + 1) % 3; // Cycle through OFF, COOL, HEAT
-            ESP_LOGI(TAG, "Mode changed to: %d", current_mode);
+            zone->mode = (zone->mode + 1) % 3; // Cycle through OFF, COOL, HEAT
+            DLOGI(TAG, "%s: Mode changed to: %d", zone->name, zone->mode);
             break;
             
         case BUTTON_BLUE_GPIO:
-            set_temperature -= TEMP_STEP;
-            if (set_temperature < MIN_TEMP) set_temperature = MIN_TEMP;
-            ESP_LOGI(TAG, "Temperature DOWN: %.1f°C", set_temperature);
+            zone->set_temperature -= TEMP_STEP;
+            if (zone->set_temperature < MIN_TEMP) zone->set_temperature = MIN_TEMP;
+            DLOGI(TAG, "%s: Temperature DOWN: %d.%d°C", zone->name, DECI_WHOLE(zone->set_temperature), DECI_TENTH(zone->set_temperature));
             break;
             
         case BUTTON_RED_GPIO:
-            set_temperature += TEMP_STEP;
-            if (set_temperature > MAX_TEMP) set_temperature = MAX_TEMP;
-            ESP_LOGI(TAG, "Temperature UP: %.1f°C", set_temperature);
+            zone->set_temperature += TEMP_STEP;
+            if (zone->set_temperature > MAX_TEMP) zone->set_temperature = MAX_TEMP;
+            DLOGI(TAG, "%s: Temperature UP: %d.%d°C", zone->name, DECI_WHOLE(zone->set_temperature), DECI_TENTH(zone->set_temperature));
             break;
     }
+    notify_display();
 }
 
-// Update control outputs based on temperature and mode
-static void update_control_outputs(void)
+// Update a zone's control outputs based on its temperature and mode
+static void update_control_outputs(zone_t *zone)
 {
-    bool new_cooling = false;
-    bool new_heating = false;
-    
-    if (current_mode == MODE_COOL) {
-        new_cooling = current_temperature > set_temperature - TEMP_MARGIN;
-    } else if (current_mode == MODE_HEAT) {
-        new_heating = current_temperature < set_temperature + TEMP_MARGIN;
+    int64_t now_us = esp_timer_get_time();
+    bool cooling_changed = false;
+    bool heating_changed = false;
+
+    // Only the mode's own relay may run. The other one, and both when the zone is OFF or its sensor is
+    // stale (fail safe), switch off right away; the minimum off time still protects the next start.
+    if (zone->mode != MODE_COOL || zone->sensor_stale) {
+        cooling_changed = relay_force_off(&zone->cooling_relay, now_us);
+    }
+    if (zone->mode != MODE_HEAT || zone->sensor_stale) {
+        heating_changed = relay_force_off(&zone->heating_relay, now_us);
+    }
+
+    if (zone->mode == MODE_OFF || zone->sensor_stale) {
+        // Relays already OFF, the PID starts over when control resumes
+        zone->pid_mode = MODE_OFF;
     } else {
-        // MODE_OFF - turn off all controls
-        new_cooling = false;
-        new_heating = false;
+        // The relay holds a request until its minimum run or off time is up
+        relay_t *relay = zone->mode == MODE_COOL ? &zone->cooling_relay : &zone->heating_relay;
+        bool on = zone->control == CONTROL_PID ? pid_demand(zone, relay, now_us) : on_off_demand(zone, relay);
+        if (relay_request(relay, on, now_us)) {
+            cooling_changed |= relay == &zone->cooling_relay;
+            heating_changed |= relay == &zone->heating_relay;
+        }
     }
-    
-    // Update control outputs
-    if (cooling_active != new_cooling) {
-        cooling_active = new_cooling;
-        gpio_set_level(COOLING_GPIO, cooling_active ? 0 : 1);
-        ESP_LOGI(TAG, "Cooling %s", cooling_active ? "ACTIVATED" : "DEACTIVATED");
+
+    if (cooling_changed) {
+        DLOGI(TAG, "%s: Cooling %s", zone->name, zone->cooling_relay.on ? "ACTIVATED" : "DEACTIVATED");
     }
-    
-    if (heating_active != new_heating) {
-        heating_active = new_heating;
-        gpio_set_level(HEATING_GPIO, heating_active ? 0 : 1);
-        ESP_LOGI(TAG, "Heating %s", heating_active ? "ACTIVATED" : "DEACTIVATED");
+    if (heating_changed) {
+        DLOGI(TAG, "%s: Heating %s", zone->name, zone->heating_relay.on ? "ACTIVATED" : "DEACTIVATED");
+    }
+    if (cooling_changed || heating_changed) {
+        notify_display();
+    }
+}
+
+// On/off control - on beyond the setpoint by TEMP_MARGIN, off back at the setpoint, unchanged in between
+static bool on_off_demand(const zone_t *zone, const relay_t *relay)
+{
+    deci_t excess = zone->mode == MODE_COOL ? zone->current_temperature - zone->set_temperature
+                                            : zone->set_temperature - zone->current_temperature;
+    if (excess > TEMP_MARGIN) {
+        return true;
+    }
+    if (excess <= 0) {
+        return false;
     }
+    return relay->on;
+}
+
+// PID control - slow PWM from the controller output, or relay feedback while the mode is autotuned.
+// Falls back to on/off control if autotuning fails, until the mode is selected again.
+static bool pid_demand(zone_t *zone, const relay_t *relay, int64_t now_us)
+{
+    bool cooling = zone->mode == MODE_COOL;
+    pid_gains_t *gains = cooling ? &zone->cooling_gains : &zone->heating_gains;
+
+    if (zone->pid_mode != zone->mode) {
+        zone->pid_mode = zone->mode;
+        pid_reset(&zone->pid, gains, cooling);
+        slow_pwm_reset(&zone->pwm, PID_PWM_WINDOW_MS, RELAY_MIN_ON_MS, RELAY_MIN_OFF_MS);
+        zone->pid_updated_us = 0;
+        zone->autotuning = gains->kp == 0 && gains->ki == 0;
+        if (zone->autotuning) {
+            pid_autotune_start(&zone->autotune, zone->set_temperature, PID_AUTOTUNE_HYSTERESIS, cooling, now_us);
+            DLOGI(TAG, "%s: Autotune started at %d.%d°C", zone->name,
+                  DECI_WHOLE(zone->set_temperature), DECI_TENTH(zone->set_temperature));
+        }
+    } else if (zone->autotuning && zone->autotune.setpoint != zone->set_temperature) {
+        // The oscillation measured so far is around the old setpoint, tune again around the new one
+        pid_autotune_start(&zone->autotune, zone->set_temperature, PID_AUTOTUNE_HYSTERESIS, cooling, now_us);
+        DLOGI(TAG, "%s: Autotune restarted at %d.%d°C", zone->name,
+              DECI_WHOLE(zone->set_temperature), DECI_TENTH(zone->set_temperature));
+    }
+
+    if (zone->autotuning) {
+        bool on = false;
+        pid_autotune_state_t state = pid_autotune_update(&zone->autotune, zone->current_temperature, now_us, &on);
+        if (state == PID_AUTOTUNE_RUNNING) {
+            return on;
+        }
+        zone->autotuning = false;
+        if (state == PID_AUTOTUNE_DONE && pid_autotune_gains(&zone->autotune, gains)) {
+            pid_reset(&zone->pid, gains, cooling);
+            ESP_LOGI(TAG, "%s: Autotune done, %s gains { .kp = %ld, .ki = %ld }, oscillation %ld tenths every %lld s",
+                     zone->name, cooling ? "cooling" : "heating", gains->kp, gains->ki,
+                     zone->autotune.amplitude_sum / zone->autotune.cycles,
+                     zone->autotune.period_sum_us / zone->autotune.cycles / 1000000);
+        } else {
+            ESP_LOGW(TAG, "%s: Autotune found no steady oscillation, using on/off control", zone->name);
+        }
+    }
+    if (gains->kp == 0 && gains->ki == 0) {
+        return on_off_demand(zone, relay);
+    }
+
+    if (zone->pid_updated_us == 0 || now_us - zone->pid_updated_us >= (int64_t)PID_SAMPLE_MS * 1000) {
+        uint32_t dt_ms = zone->pid_updated_us != 0 ? (uint32_t)((now_us - zone->pid_updated_us) / 1000) : 0;
+        pid_update(&zone->pid, zone->set_temperature, zone->current_temperature, dt_ms);
+        zone->pid_updated_us = now_us;
+    }
+    return slow_pwm_update(&zone->pwm, zone->pid.output, now_us);
 }
 
 // Update display with current information
 static void update_display(void)
 {
-    const translations_t* t = get_translations();
-    
-    // Clear the screen
-    ssd1306_clear();
-    
-    // Display temperature based on mode
-    char temp_line[32];
-    if (current_mode == MODE_OFF) {
-        // When OFF, show only current temperature
-        snprintf(temp_line, sizeof(temp_line), "%.1f C", current_temperature);
+    const zone_t *zone = &zones[selected_zone];
+    bool changed = false;
+
+    ssd1306_begin_frame();
+
+    changed |= ui_widget_update(&temperature_widget, zone->current_temperature);
+    // When OFF, show only current temperature
+    changed |= ui_widget_update(&setpoint_widget, zone->mode == MODE_OFF ? UI_WIDGET_HIDDEN : zone->set_temperature);
+    changed |= ui_widget_update(&humidity_widget, zone->current_humidity);
+    // The mode label turns into a wiring warning while the zone's sensor is stale
+    changed |= ui_widget_update(&mode_label_widget, zone->sensor_stale);
+    changed |= ui_widget_update(&mode_widget, zone->mode);
+
+    // Only send a frame when a widget was redrawn
+    if (changed) {
+        ssd1306_display();
     } else {
-        // When COOL or HEAT, show current temperature with desired in parentheses
-        snprintf(temp_line, sizeof(temp_line), "%.1f C (%.1f)", current_temperature, set_temperature);
+        ssd1306_end_frame();
     }
-    ssd1306_print_str(0, 0, temp_line, false);
-    
-    // Display humidity
-    char hum_line[32];
-    snprintf(hum_line, sizeof(hum_line), "%.1f %%", current_humidity);
-    ssd1306_print_str(0, 10, hum_line, false);
-    
-    // Display mode
+}
+
+// Widget formatters
+static void format_temperature(char *text, size_t size, int32_t value)
+{
+    static const num_format_t temperature_format = { .decimals = 1, .unit = "°" };
+    num_format(text, size, value, &temperature_format);
+}
+
+static void format_setpoint(char *text, size_t size, int32_t value)
+{
+    static const num_format_t setpoint_format = { .decimals = 1, .prefix = "(", .unit = ")" };
+    num_format(text, size, value, &setpoint_format);
+}
+
+static void format_humidity(char *text, size_t size, int32_t value)
+{
+    static const num_format_t humidity_format = { .decimals = 1, .unit = " %" };
+    num_format(text, size, value, &humidity_format);
+}
+
+static void format_mode_label(char *text, size_t size, int32_t value)
+{
+    const translations_t* t = get_translations();
+    snprintf(text, size, "%s", value ? t->check_wiring : t->mode_label);
+}
+
+static void format_mode(char *text, size_t size, int32_t value)
+{
+    const translations_t* t = get_translations();
     const char* mode_str;
-    switch (current_mode) {
+
+    switch (value) {
         case MODE_COOL:
             mode_str = t->mode_cool;
             break;
@@ -303,11 +792,7 @@ static void update_display(void)
             mode_str = t->mode_off;
             break;
     }
-    ssd1306_print_str(0, 30, t->mode_label, false);
-    ssd1306_print_str(0, 40, mode_str, false);
-    
-    // Update display
-    ssd1306_display();
+    snprintf(text, size, "%s", mode_str);
 }
 
 // Helper function to get button index from GPIO number
@@ -0,0 +1,64 @@
+#include "num_format.h"
+
+// Longest number: sign, 10 digits, point and the leading zero of a value below 1
+#define NUM_FORMAT_MAX_DIGITS 14
+
+static const num_format_t plain_format = { 0 };
+
+static size_t num_format_append(char *text, size_t size, size_t length, const char *append)
+{
+    while (append != NULL && *append != '\0' && length + 1 < size) {
+        text[length++] = *append++;
+    }
+    return length;
+}
+
+size_t num_format(char *text, size_t size, int32_t value, const num_format_t *format)
+{
+    if (size == 0) {
+        return 0;
+    }
+    if (format == NULL) {
+        format = &plain_format;
+    }
+
+    // Digits are produced from the last decimal up, then copied in reading order
+    char reversed[NUM_FORMAT_MAX_DIGITS];
+    size_t digits = 0;
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    uint8_t decimals = format->decimals < NUM_FORMAT_MAX_DECIMALS ? format->decimals : NUM_FORMAT_MAX_DECIMALS;
+    for (uint8_t i = 0; i < decimals; i++) {
+        reversed[digits++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    }
+    if (decimals > 0) {
+        reversed[digits++] = '.';
+    }
+    do {
+        reversed[digits++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    char sign = value < 0 ? '-' : (format->plus && value > 0 ? '+' : '\0');
+    size_t number_width = digits + (sign != '\0');
+    size_t padding = format->width > number_width ? format->width - number_width : 0;
+
+    size_t length = num_format_append(text, size, 0, format->prefix);
+    if (!format->zero_pad) {
+        for (; padding > 0 && length + 1 < size; padding--) {
+            text[length++] = ' ';
+        }
+    }
+    if (sign != '\0' && length + 1 < size) {
+        text[length++] = sign;
+    }
+    for (; padding > 0 && length + 1 < size; padding--) {
+        text[length++] = '0';
+    }
+    while (digits > 0 && length + 1 < size) {
+        text[length++] = reversed[--digits];
+    }
+    length = num_format_append(text, size, length, format->unit);
+    text[length] = '\0';
+    return length;
+}
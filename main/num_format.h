@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Number formatting - bounded, allocation-free and integer-only replacement for snprintf("%.1f") and
+// friends on the render path. Values are fixed-point integers with an implied number of decimals,
+// e.g. 225 with 1 decimal is "22.5".
+
+#define NUM_FORMAT_MAX_DECIMALS 9
+
+typedef struct {
+    uint8_t decimals;       // Implied decimals of the value, at most NUM_FORMAT_MAX_DECIMALS
+    uint8_t width;          // Minimum width of the number, sign included; 0 for no padding
+    bool zero_pad;          // Pad with zeros after the sign instead of spaces before it
+    bool plus;              // Show '+' on positive values
+    const char *prefix;     // Text before the number, nullable
+    const char *unit;       // Text after the number, nullable
+} num_format_t;
+
+// Write value into text as described by format (NULL for a plain integer). The output is truncated
+// to size and always terminated when size > 0. Returns the length written, without the terminator.
+size_t num_format(char *text, size_t size, int32_t value, const num_format_t *format);
@@ -0,0 +1,92 @@
+#include "pid_autotune.h"
+
+// pi * 3.2 in thousandths, the Tyreus-Luyben proportional divisor folded into Ku
+#define PID_AUTOTUNE_PI_TL_1000 10053
+
+static uint32_t pid_autotune_isqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    for (uint32_t bit = 1u << 30; bit > 0; bit >>= 2) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+void pid_autotune_start(pid_autotune_t *tune, deci_t setpoint, deci_t hysteresis, bool reverse, int64_t now_us)
+{
+    *tune = (pid_autotune_t){ .state = PID_AUTOTUNE_RUNNING, .setpoint = setpoint, .hysteresis = hysteresis,
+                              .reverse = reverse, .start_us = now_us };
+}
+
+pid_autotune_state_t pid_autotune_update(pid_autotune_t *tune, deci_t measurement, int64_t now_us, bool *on)
+{
+    if (tune->state == PID_AUTOTUNE_RUNNING && now_us - tune->start_us > (int64_t)PID_AUTOTUNE_MAX_MS * 1000) {
+        tune->state = PID_AUTOTUNE_FAILED;
+    }
+    if (tune->state != PID_AUTOTUNE_RUNNING) {
+        tune->on = false;
+        *on = false;
+        return tune->state;
+    }
+
+    deci_t error = tune->reverse ? measurement - tune->setpoint : tune->setpoint - measurement;
+    if (error > tune->high) {
+        tune->high = error;
+    }
+    if (error < tune->low) {
+        tune->low = error;
+    }
+
+    if (!tune->on && error > tune->hysteresis) {
+        // A cycle ends at each switch on; the one after the first is the first steady one
+        if (tune->starts >= 2) {
+            tune->amplitude_sum += tune->high - tune->low;
+            tune->period_sum_us += now_us - tune->cycle_start_us;
+            if (++tune->cycles >= PID_AUTOTUNE_CYCLES) {
+                tune->state = PID_AUTOTUNE_DONE;
+                tune->on = false;
+                *on = false;
+                return tune->state;
+            }
+        }
+        tune->starts++;
+        tune->cycle_start_us = now_us;
+        tune->high = error;
+        tune->low = error;
+        tune->on = true;
+    } else if (tune->on && error < -tune->hysteresis) {
+        tune->on = false;
+    }
+    *on = tune->on;
+    return tune->state;
+}
+
+bool pid_autotune_gains(const pid_autotune_t *tune, pid_gains_t *gains)
+{
+    if (tune->state != PID_AUTOTUNE_DONE) {
+        return false;
+    }
+
+    // Half the peak to peak amplitude in hundredths, less the hysteresis the relay adds
+    uint32_t amplitude = (uint32_t)tune->amplitude_sum * 10 / (2 * tune->cycles);
+    uint32_t hysteresis = (uint32_t)tune->hysteresis * 10;
+    if (amplitude > hysteresis) {
+        amplitude = pid_autotune_isqrt(amplitude * amplitude - hysteresis * hysteresis);
+    }
+    if (amplitude == 0) {
+        amplitude = 1;
+    }
+    int64_t period_ms = tune->period_sum_us / tune->cycles / 1000;
+
+    // Kp = Ku / 3.2 with Ku = 4 * (PID_OUTPUT_MAX / 2) / (pi * a), a in tenths
+    int64_t kp = ((int64_t)2 * PID_OUTPUT_MAX * 1000 * 10 << PID_GAIN_SHIFT) / ((int64_t)PID_AUTOTUNE_PI_TL_1000 * amplitude);
+    // Ki = Kp / Ti with Ti = 2.2 Tu
+    int64_t ki = period_ms > 0 ? kp * 10000 / (22 * period_ms) : 0;
+    *gains = (pid_gains_t){ .kp = (int32_t)kp, .ki = (int32_t)ki, .kd = 0 };
+    return true;
+}
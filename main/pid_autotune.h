@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "deci.h"
+#include "pid_control.h"
+
+// PID autotune - relay feedback (Astrom-Hagglund). The relay is switched fully on below the setpoint
+// and off above it, with a small hysteresis against sensor noise, until the temperature oscillates.
+// The amplitude a and period Tu of the oscillation give the ultimate gain Ku = 4d / (pi * a), d being
+// half the output span, from which Tyreus-Luyben PI gains are derived: Kp = Ku / 3.2, Ti = 2.2 Tu.
+// Tyreus-Luyben trades some speed for much less overshoot than Ziegler-Nichols, which suits a room.
+// No derivative gain is derived; on tenth-of-a-degree readings it mostly amplifies quantization.
+
+#define PID_AUTOTUNE_CYCLES 3                  // Oscillations averaged, the first one is discarded
+#define PID_AUTOTUNE_MAX_MS (8 * 3600000)      // Give up after 8 hours without enough oscillations
+
+typedef enum {
+    PID_AUTOTUNE_RUNNING,
+    PID_AUTOTUNE_DONE,
+    PID_AUTOTUNE_FAILED
+} pid_autotune_state_t;
+
+typedef struct {
+    pid_autotune_state_t state;
+    deci_t setpoint;
+    deci_t hysteresis;
+    bool reverse;                  // Relay on above the setpoint, for cooling
+    bool on;
+    int64_t start_us;
+    int64_t cycle_start_us;        // Time of the last switch on
+    uint8_t starts;                // Switches on so far
+    deci_t high;                   // Error extremes of the current cycle
+    deci_t low;
+    uint8_t cycles;                // Cycles measured
+    int32_t amplitude_sum;         // Peak to peak error, tenths
+    int64_t period_sum_us;
+} pid_autotune_t;
+
+// Start tuning around setpoint, the relay off
+void pid_autotune_start(pid_autotune_t *tune, deci_t setpoint, deci_t hysteresis, bool reverse, int64_t now_us);
+
+// Feed a measurement. *on is set to the relay state wanted; it is off once tuning is over.
+pid_autotune_state_t pid_autotune_update(pid_autotune_t *tune, deci_t measurement, int64_t now_us, bool *on);
+
+// Gains from a finished tuning. Returns false if tuning is not done.
+bool pid_autotune_gains(const pid_autotune_t *tune, pid_gains_t *gains);
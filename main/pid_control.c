@@ -0,0 +1,58 @@
+#include "pid_control.h"
+
+void pid_reset(pid_controller_t *pid, const pid_gains_t *gains, bool reverse)
+{
+    *pid = (pid_controller_t){ .gains = *gains, .reverse = reverse };
+}
+
+int32_t pid_update(pid_controller_t *pid, deci_t setpoint, deci_t measurement, uint32_t dt_ms)
+{
+    const int64_t max = (int64_t)PID_OUTPUT_MAX << PID_GAIN_SHIFT;
+    int32_t error = pid->reverse ? measurement - setpoint : setpoint - measurement;
+
+    int64_t derivative = 0;
+    if (pid->started && dt_ms > 0) {
+        // Rate of change of the measurement, signed like the error
+        int32_t change = pid->reverse ? measurement - pid->last_measurement : pid->last_measurement - measurement;
+        derivative = (int64_t)pid->gains.kd * change * 1000 / dt_ms;
+    }
+    int64_t proportional = (int64_t)pid->gains.kp * error;
+
+    int64_t integral = pid->integral + (int64_t)pid->gains.ki * error * dt_ms / 1000;
+    integral = integral < 0 ? 0 : (integral > max ? max : integral);
+    int64_t output = proportional + integral + derivative;
+    // Anti-windup - keep the integral where it was while the output is saturated the way the error pushes
+    if ((output > max && error > 0) || (output < 0 && error < 0)) {
+        integral = pid->integral;
+        output = proportional + integral + derivative;
+    }
+    pid->integral = integral;
+    pid->last_measurement = measurement;
+    pid->started = true;
+
+    output = output < 0 ? 0 : (output > max ? max : output);
+    pid->output = (int32_t)(output >> PID_GAIN_SHIFT);
+    return pid->output;
+}
+
+void slow_pwm_reset(slow_pwm_t *pwm, uint32_t window_ms, uint32_t min_on_ms, uint32_t min_off_ms)
+{
+    *pwm = (slow_pwm_t){ .window_ms = window_ms, .min_on_ms = min_on_ms, .min_off_ms = min_off_ms };
+}
+
+bool slow_pwm_update(slow_pwm_t *pwm, int32_t output, int64_t now_us)
+{
+    if (!pwm->started || now_us - pwm->window_start_us >= (int64_t)pwm->window_ms * 1000) {
+        output = output < 0 ? 0 : (output > PID_OUTPUT_MAX ? PID_OUTPUT_MAX : output);
+        uint32_t on_ms = (uint32_t)((uint64_t)pwm->window_ms * output / PID_OUTPUT_MAX);
+        if (on_ms < pwm->min_on_ms) {
+            on_ms = 0;
+        } else if (pwm->window_ms - on_ms < pwm->min_off_ms) {
+            on_ms = pwm->window_ms;
+        }
+        pwm->on_ms = on_ms;
+        pwm->window_start_us = now_us;
+        pwm->started = true;
+    }
+    return now_us - pwm->window_start_us < (int64_t)pwm->on_ms * 1000;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "deci.h"
+
+// PID control - fixed-point PID with anti-windup driving a relay through slow PWM (time-proportioning).
+// Measurements are in tenths (deci_t), the output in per mille of full power. Times are passed in by
+// the caller, so the module runs unchanged in a host simulation.
+//
+// The derivative acts on the measurement, not the error, so a setpoint change gives no kick. The
+// integral is clamped to the output range and frozen while the output is saturated in the direction
+// the error pushes it (conditional integration), so it never winds up during a long heat-up.
+
+#define PID_GAIN_SHIFT 16          // Gains are fixed point with 16 fraction bits
+#define PID_OUTPUT_MAX 1000        // Full power, per mille
+
+typedef struct {
+    int32_t kp;     // Per mille per tenth of a degree of error
+    int32_t ki;     // Per mille per tenth of a degree of error per second
+    int32_t kd;     // Per mille per tenth of a degree per second of change, times a second
+} pid_gains_t;
+
+typedef struct {
+    pid_gains_t gains;
+    bool reverse;                  // Output rises with the measurement, for cooling
+    bool started;
+    int64_t integral;              // I term in per mille, PID_GAIN_SHIFT fraction bits
+    deci_t last_measurement;
+    int32_t output;                // Last output, per mille
+} pid_controller_t;
+
+// Time-proportioning over a window: the output latched at the start of each window is the share of
+// it the relay is on. A run shorter than min_on_ms is skipped and a rest shorter than min_off_ms is
+// filled in, so the relay's minimum times never stretch the duty cycle by surprise.
+typedef struct {
+    uint32_t window_ms;
+    uint32_t min_on_ms;
+    uint32_t min_off_ms;
+    bool started;
+    int64_t window_start_us;
+    uint32_t on_ms;                // On time in the current window
+} slow_pwm_t;
+
+// Restart the controller with new gains, integral cleared
+void pid_reset(pid_controller_t *pid, const pid_gains_t *gains, bool reverse);
+
+// Run one step, dt_ms after the previous one (0 on the first). Returns the output, per mille.
+int32_t pid_update(pid_controller_t *pid, deci_t setpoint, deci_t measurement, uint32_t dt_ms);
+
+// Restart the PWM, the next update opens a new window
+void slow_pwm_reset(slow_pwm_t *pwm, uint32_t window_ms, uint32_t min_on_ms, uint32_t min_off_ms);
+
+// Whether the relay should be on now for the given output, per mille
+bool slow_pwm_update(slow_pwm_t *pwm, int32_t output, int64_t now_us);
@@ -0,0 +1,46 @@
+#include "relay.h"
+
+static void relay_switch(relay_t *relay, bool on, int64_t now_us)
+{
+    if (on) {
+        relay->starts++;
+    } else {
+        relay->on_us += now_us - relay->changed_us;
+    }
+    relay->on = on;
+    relay->changed_us = now_us;
+    gpio_set_level(relay->gpio, on ? RELAY_ON_LEVEL : !RELAY_ON_LEVEL);
+}
+
+void relay_init(relay_t *relay, gpio_num_t gpio, uint32_t min_on_ms, uint32_t min_off_ms, int64_t now_us)
+{
+    *relay = (relay_t){ .gpio = gpio, .min_on_ms = min_on_ms, .min_off_ms = min_off_ms, .changed_us = now_us };
+    gpio_set_level(gpio, !RELAY_ON_LEVEL);
+}
+
+bool relay_request(relay_t *relay, bool on, int64_t now_us)
+{
+    if (on == relay->on) {
+        return false;
+    }
+    uint32_t hold_ms = relay->on ? relay->min_on_ms : relay->min_off_ms;
+    if (now_us - relay->changed_us < (int64_t)hold_ms * 1000) {
+        return false;
+    }
+    relay_switch(relay, on, now_us);
+    return true;
+}
+
+bool relay_force_off(relay_t *relay, int64_t now_us)
+{
+    if (!relay->on) {
+        return false;
+    }
+    relay_switch(relay, false, now_us);
+    return true;
+}
+
+uint64_t relay_on_time_us(const relay_t *relay, int64_t now_us)
+{
+    return relay->on_us + (relay->on ? now_us - relay->changed_us : 0);
+}
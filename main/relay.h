@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driver/gpio.h"
+
+// Relay - drives one compressor or heater relay and keeps it from short-cycling. Once switched, a
+// relay stays on for at least its minimum run time and off for at least its minimum off time; a
+// request made sooner is held until the time is up. Starts and on time are counted so the duty cycle
+// and starts per hour can be reported. Times are esp_timer microseconds passed in by the caller.
+
+#define RELAY_ON_LEVEL 0        // The relay boards are active low
+
+typedef struct {
+    gpio_num_t gpio;
+    uint32_t min_on_ms;         // Minimum run time
+    uint32_t min_off_ms;        // Minimum off time, also applied after relay_init()
+    bool on;
+    int64_t changed_us;         // Time of the last switch, or of relay_init()
+    uint32_t starts;            // Off to on transitions
+    uint64_t on_us;             // Time on, up to the last switch off
+} relay_t;
+
+// Drive the relay OFF. Can be called before the pin is an output, the level is latched.
+void relay_init(relay_t *relay, gpio_num_t gpio, uint32_t min_on_ms, uint32_t min_off_ms, int64_t now_us);
+
+// Ask for the relay on or off, honouring the minimum run and off times. Returns true if it switched.
+bool relay_request(relay_t *relay, bool on, int64_t now_us);
+
+// Switch off right away, skipping the minimum run time - for a mode change or a fail-safe. The
+// minimum off time still delays the next start. Returns true if it switched.
+bool relay_force_off(relay_t *relay, int64_t now_us);
+
+// Total time on, the current run included
+uint64_t relay_on_time_us(const relay_t *relay, int64_t now_us);
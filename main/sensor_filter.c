@@ -0,0 +1,63 @@
+#include "sensor_filter.h"
+#include <string.h>
+
+void sensor_filter_reset(sensor_filter_t *filter)
+{
+    memset(filter, 0, sizeof(*filter));
+}
+
+// Median of the readings in the window, insertion sort of a copy - the window is tiny
+static deci_t sensor_filter_median(const sensor_filter_t *filter)
+{
+    deci_t sorted[SENSOR_FILTER_WINDOW];
+    for (uint8_t i = 0; i < filter->count; i++) {
+        deci_t value = filter->window[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    return sorted[filter->count / 2];
+}
+
+bool sensor_filter_update(sensor_filter_t *filter, deci_t raw, deci_t *filtered)
+{
+    if (filter->count > 0) {
+        int32_t step = (int32_t)raw - filter->last;
+        if (step > SENSOR_FILTER_MAX_STEP || step < -SENSOR_FILTER_MAX_STEP) {
+            // Only rejects close to the first one count towards a new level, any other starts over
+            int32_t drift = (int32_t)raw - filter->candidate;
+            if (filter->rejects == 0 || drift > SENSOR_FILTER_MAX_STEP || drift < -SENSOR_FILTER_MAX_STEP) {
+                filter->candidate = raw;
+                filter->rejects = 0;
+            }
+            if (++filter->rejects < SENSOR_FILTER_MAX_REJECTS) {
+                return false;
+            }
+            // The new level persisted, start over from it
+            sensor_filter_reset(filter);
+        }
+    }
+    filter->rejects = 0;
+    filter->last = raw;
+
+    filter->window[filter->head] = raw;
+    filter->head = (filter->head + 1) % SENSOR_FILTER_WINDOW;
+    if (filter->count < SENSOR_FILTER_WINDOW) {
+        filter->count++;
+    }
+
+    int32_t median = (int32_t)sensor_filter_median(filter) * (1 << SENSOR_FILTER_EMA_FRACTION);
+    if (filter->count == 1) {
+        filter->ema = median;
+    } else {
+        filter->ema += (median - filter->ema) / (1 << SENSOR_FILTER_EMA_SHIFT);
+    }
+
+    // Round to the nearest tenth, halves away from zero
+    int32_t half = 1 << (SENSOR_FILTER_EMA_FRACTION - 1);
+    *filtered = (deci_t)((filter->ema + (filter->ema < 0 ? -half : half)) / (1 << SENSOR_FILTER_EMA_FRACTION));
+    return true;
+}
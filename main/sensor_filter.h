@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "deci.h"
+
+// Sensor filter - rate-of-change gate, median of the last SENSOR_FILTER_WINDOW readings, then an EMA.
+// Values are in tenths (deci_t); no allocation, no floating point.
+//
+// The gate rejects a reading that moves more than SENSOR_FILTER_MAX_STEP from the last accepted one,
+// which catches glitches that pass the checksum. SENSOR_FILTER_MAX_REJECTS rejected readings in a row,
+// each within SENSOR_FILTER_MAX_STEP of the first, are a real change (or a new sensor), so the filter
+// restarts from them. Rejected readings that disagree with each other are glitches and never restart it.
+
+#define SENSOR_FILTER_WINDOW 5             // Median window, odd
+#define SENSOR_FILTER_EMA_SHIFT 2          // EMA weight of a new median, 1/4
+#define SENSOR_FILTER_EMA_FRACTION 4       // Fraction bits kept by the EMA
+#define SENSOR_FILTER_MAX_STEP DECI(2.0)   // Largest change between readings, degrees or %
+#define SENSOR_FILTER_MAX_REJECTS 3
+
+typedef struct {
+    deci_t window[SENSOR_FILTER_WINDOW];   // Ring buffer of accepted readings
+    uint8_t head;
+    uint8_t count;
+    uint8_t rejects;                       // Consecutive rejected readings that agree with 'candidate'
+    deci_t candidate;                      // First rejected reading of a possible new level
+    deci_t last;                           // Last accepted reading
+    int32_t ema;                           // Scaled by 2^SENSOR_FILTER_EMA_FRACTION
+} sensor_filter_t;
+
+// Reset the filter, the next reading is accepted as is. A zero-initialized filter is reset.
+void sensor_filter_reset(sensor_filter_t *filter);
+
+// Feed a raw reading. Returns false if the gate rejected it; otherwise the filtered value is
+// stored in *filtered.
+bool sensor_filter_update(sensor_filter_t *filter, deci_t raw, deci_t *filtered);
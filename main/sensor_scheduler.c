@@ -0,0 +1,198 @@
+#include "sensor_scheduler.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "dht_rmt.h"
+
+static const char *TAG = "SENSOR_SCHEDULER";
+
+static sensor_scheduler_sensor_t sensors[SENSOR_SCHEDULER_MAX_SENSORS];
+static sensor_scheduler_stats_t stats[SENSOR_SCHEDULER_MAX_SENSORS];
+static int64_t next_read_us[SENSOR_SCHEDULER_MAX_SENSORS];
+static int64_t last_read_us[SENSOR_SCHEDULER_MAX_SENSORS];
+static uint8_t total_sensors = 0;
+static sensor_scheduler_callback_t callback = NULL;
+static TaskHandle_t scheduler_task_handle = NULL;
+static SemaphoreHandle_t schedule_changed = NULL;          // Wakes the scheduler early after a period change
+static portMUX_TYPE schedule_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const uint16_t latency_bounds_ms[SENSOR_SCHEDULER_LATENCY_BUCKETS - 1] = SENSOR_SCHEDULER_LATENCY_BOUNDS_MS;
+
+static uint32_t sensor_scheduler_min_interval_ms(dht_sensor_type_t type)
+{
+    return type == DHT_TYPE_DHT11 ? SENSOR_SCHEDULER_DHT11_MIN_MS : SENSOR_SCHEDULER_DHT22_MIN_MS;
+}
+
+// Sensor with the earliest read due, and when it is due
+static uint8_t sensor_scheduler_next(int64_t *due_us)
+{
+    uint8_t next = 0;
+    portENTER_CRITICAL(&schedule_lock);
+    for (uint8_t i = 1; i < total_sensors; i++) {
+        if (next_read_us[i] < next_read_us[next]) {
+            next = i;
+        }
+    }
+    *due_us = next_read_us[next];
+    portEXIT_CRITICAL(&schedule_lock);
+    return next;
+}
+
+static void sensor_scheduler_task(void *pvParameter)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    // Stagger the first reads evenly over each sensor's period
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&schedule_lock);
+    for (uint8_t i = 0; i < total_sensors; i++) {
+        next_read_us[i] = now + (int64_t)sensors[i].period_ms * 1000 * i / total_sensors;
+        last_read_us[i] = now;
+    }
+    portEXIT_CRITICAL(&schedule_lock);
+
+    while (1) {
+        int64_t due_us;
+        uint8_t sensor = sensor_scheduler_next(&due_us);
+        int64_t wait_us = due_us - esp_timer_get_time();
+        if (wait_us >= portTICK_PERIOD_MS * 1000) {
+            xSemaphoreTake(schedule_changed, pdMS_TO_TICKS(wait_us / 1000));
+            continue;
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        deci_t humidity = 0;
+        deci_t temperature = 0;
+        esp_err_t result = dht_rmt_start_read(sensors[sensor].type, sensors[sensor].gpio, self);
+        if (result == ESP_OK) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DHT_RMT_READ_TIMEOUT_MS));
+            result = dht_rmt_finish_read(sensors[sensor].gpio, &humidity, &temperature);
+        }
+        int64_t end_us = esp_timer_get_time();
+
+        uint8_t bucket = 0;
+        while (bucket < SENSOR_SCHEDULER_LATENCY_BUCKETS - 1 && end_us - start_us >= latency_bounds_ms[bucket] * 1000LL) {
+            bucket++;
+        }
+
+        portENTER_CRITICAL(&schedule_lock);
+        sensor_scheduler_stats_t *sensor_stats = &stats[sensor];
+        last_read_us[sensor] = start_us;
+        sensor_stats->reads++;
+        sensor_stats->busy_us += end_us - start_us;
+        sensor_stats->latency[bucket]++;
+        if (result == ESP_OK) {
+            sensor_stats->successes++;
+            sensor_stats->consecutive_failures = 0;
+            sensor_stats->last_good_us = end_us;
+        } else {
+            if (result == ESP_ERR_INVALID_CRC) {
+                sensor_stats->crc_errors++;
+            } else if (result == ESP_ERR_TIMEOUT) {
+                sensor_stats->timeouts++;
+            } else {
+                sensor_stats->other_errors++;
+            }
+            sensor_stats->consecutive_failures++;
+        }
+        uint32_t failures = sensor_stats->consecutive_failures;
+        portEXIT_CRITICAL(&schedule_lock);
+
+        // The callback may change the period, which then applies from this read on
+        callback(sensor, result, humidity, temperature);
+
+        // Keep the period without drifting, but never read sooner than the minimum interval,
+        // e.g. after the task was held up. Failed reads are retried with exponential backoff.
+        uint32_t min_interval_ms = sensor_scheduler_min_interval_ms(sensors[sensor].type);
+        portENTER_CRITICAL(&schedule_lock);
+        if (failures > 0) {
+            uint32_t retry_ms = SENSOR_SCHEDULER_RETRY_MAX_MS;
+            if (failures <= 16 && (min_interval_ms << (failures - 1)) < retry_ms) {
+                retry_ms = min_interval_ms << (failures - 1);
+            }
+            next_read_us[sensor] = start_us + (int64_t)retry_ms * 1000;
+        } else {
+            next_read_us[sensor] = due_us + (int64_t)sensors[sensor].period_ms * 1000;
+            int64_t earliest_us = start_us + (int64_t)min_interval_ms * 1000;
+            if (next_read_us[sensor] < earliest_us) {
+                next_read_us[sensor] = earliest_us;
+            }
+        }
+        portEXIT_CRITICAL(&schedule_lock);
+
+        vTaskDelay(pdMS_TO_TICKS(SENSOR_SCHEDULER_GAP_MS));
+    }
+}
+
+esp_err_t sensor_scheduler_start(const sensor_scheduler_sensor_t *table, uint8_t total, sensor_scheduler_callback_t on_read)
+{
+    if (scheduler_task_handle != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (total == 0 || total > SENSOR_SCHEDULER_MAX_SENSORS || on_read == NULL) {
+        ESP_LOGE(TAG, "Invalid sensor table, it must have between 1 and %d sensors", SENSOR_SCHEDULER_MAX_SENSORS);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(sensors, table, total * sizeof(*table));
+    for (uint8_t i = 0; i < total; i++) {
+        uint32_t min_interval_ms = sensor_scheduler_min_interval_ms(sensors[i].type);
+        if (sensors[i].period_ms < min_interval_ms) {
+            ESP_LOGW(TAG, "Sensor on GPIO %d read every %lu ms, its minimum interval", sensors[i].gpio, min_interval_ms);
+            sensors[i].period_ms = min_interval_ms;
+        }
+        stats[i].period_ms = sensors[i].period_ms;
+    }
+    total_sensors = total;
+    callback = on_read;
+
+    schedule_changed = xSemaphoreCreateBinary();
+    if (schedule_changed == NULL ||
+        xTaskCreate(sensor_scheduler_task, "sensor_task", SENSOR_SCHEDULER_STACK_SIZE, NULL,
+                    SENSOR_SCHEDULER_PRIORITY, &scheduler_task_handle) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void sensor_scheduler_set_period(uint8_t sensor, uint32_t period_ms)
+{
+    if (sensor >= total_sensors) {
+        return;
+    }
+    uint32_t min_interval_ms = sensor_scheduler_min_interval_ms(sensors[sensor].type);
+    if (period_ms < min_interval_ms) {
+        period_ms = min_interval_ms;
+    }
+
+    bool sooner = false;
+    portENTER_CRITICAL(&schedule_lock);
+    sensors[sensor].period_ms = period_ms;
+    stats[sensor].period_ms = period_ms;
+    // A shorter period takes effect now instead of after the read already scheduled, unless the
+    // sensor is failing - then the next read is a backoff retry and last_read_us is a failed read
+    int64_t due_us = last_read_us[sensor] + (int64_t)period_ms * 1000;
+    if (stats[sensor].consecutive_failures == 0 && due_us < next_read_us[sensor]) {
+        next_read_us[sensor] = due_us;
+        sooner = true;
+    }
+    portEXIT_CRITICAL(&schedule_lock);
+
+    if (sooner && xTaskGetCurrentTaskHandle() != scheduler_task_handle) {
+        xSemaphoreGive(schedule_changed);
+    }
+}
+
+esp_err_t sensor_scheduler_get_stats(uint8_t sensor, sensor_scheduler_stats_t *sensor_stats)
+{
+    if (sensor >= total_sensors) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&schedule_lock);
+    *sensor_stats = stats[sensor];
+    portEXIT_CRITICAL(&schedule_lock);
+    return ESP_OK;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "dht.h"
+#include "deci.h"
+
+// Sensor scheduler - one task reads every DHT sensor in turn. The first reads are staggered over the
+// period, a sensor is never read sooner than its minimum interval, and consecutive reads of different
+// sensors are at least SENSOR_SCHEDULER_GAP_MS apart, so timing-critical reads never run back to back.
+// A failed read is retried after the minimum interval, doubling on every consecutive failure up to
+// SENSOR_SCHEDULER_RETRY_MAX_MS, and every read is accounted in the sensor's health counters.
+
+#define SENSOR_SCHEDULER_MAX_SENSORS 8
+#define SENSOR_SCHEDULER_DHT11_MIN_MS 1000     // Shortest time between two reads of a DHT11
+#define SENSOR_SCHEDULER_DHT22_MIN_MS 2000     // Same for the AM2301 family and the Si7021
+#define SENSOR_SCHEDULER_GAP_MS 50             // Quiet time after each read
+#define SENSOR_SCHEDULER_RETRY_MAX_MS 60000    // Longest time between retries of a failing sensor
+#define SENSOR_SCHEDULER_LATENCY_BUCKETS 5     // Read latency histogram: <24, <26, <30, <50, >=50 ms
+#define SENSOR_SCHEDULER_LATENCY_BOUNDS_MS { 24, 26, 30, 50 }
+#define SENSOR_SCHEDULER_STACK_SIZE 3072
+#define SENSOR_SCHEDULER_PRIORITY 4
+
+typedef struct {
+    dht_sensor_type_t type;
+    gpio_num_t gpio;
+    uint32_t period_ms;     // Time between reads, raised to the sensor's minimum interval
+} sensor_scheduler_sensor_t;
+
+typedef struct {
+    uint32_t reads;         // Reads since the scheduler started, failed ones included
+    uint32_t period_ms;     // Current period
+    uint64_t busy_us;       // Time the sensor line was in use, start pulse included
+    // Health - only timeouts point to a dead or disconnected sensor, CRC and other errors mixed
+    // with good reads to flaky wiring
+    uint32_t successes;
+    uint32_t crc_errors;
+    uint32_t timeouts;
+    uint32_t other_errors;          // Incomplete frames and RMT errors
+    uint32_t consecutive_failures;
+    int64_t last_good_us;           // esp_timer time of the last good read, 0 if none yet
+    uint32_t latency[SENSOR_SCHEDULER_LATENCY_BUCKETS];     // Reads per latency bucket, start pulse included
+} sensor_scheduler_stats_t;
+
+// Called from the scheduler task after every read. Humidity and temperature are only valid when
+// result is ESP_OK.
+typedef void (*sensor_scheduler_callback_t)(uint8_t sensor, esp_err_t result, deci_t humidity, deci_t temperature);
+
+// Copy the sensor table and start the scheduler task
+esp_err_t sensor_scheduler_start(const sensor_scheduler_sensor_t *sensors, uint8_t total_sensors,
+                                 sensor_scheduler_callback_t callback);
+
+// Change a sensor's period, raised to its minimum interval. A shorter period takes effect right
+// away, a longer one from the next read, and neither cuts short the retry backoff of a failing
+// sensor. Safe to call from any task, the callback included.
+void sensor_scheduler_set_period(uint8_t sensor, uint32_t period_ms);
+
+// Read a sensor's counters
+esp_err_t sensor_scheduler_get_stats(uint8_t sensor, sensor_scheduler_stats_t *stats);
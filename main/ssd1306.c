@@ -1,5 +1,8 @@
 #include "ssd1306.h"
 #include "ssd1306_const.h"
+#include <inttypes.h>
+#include "esp_timer.h"
+#include "num_format.h"
 
 
 uint8_t ssd1306_logo[8][64] = {
@@ -37,6 +40,7 @@ uint8_t ssd1306_logo[8][64] = {
      0xDF, 0xDF, 0xDF, 0xDF, 0xDF, 0xDF, 0xDF, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}
 };
 
+#ifdef ESP_PLATFORM
 static i2c_ssd1306_handle_t i2c_ssd1306;
 static i2c_master_bus_handle_t i2c_master_bus;
 
@@ -56,7 +60,8 @@ static const i2c_ssd1306_config_t i2c_ssd1306_config = {
     .i2c_scl_speed_hz = 400000,
     .width = 128,
     .height = 64,
-    .wise = SSD1306_BOTTOM_TO_TOP};
+    .wise = SSD1306_BOTTOM_TO_TOP,
+    .addr_mode = SSD1306_ADDR_MODE_HORIZONTAL};
 
 
 void init_ssd1306(void)
@@ -67,6 +72,12 @@ void init_ssd1306(void)
     i2c_ssd1306_buffer_to_ram(&i2c_ssd1306);
     vTaskDelay(1000 / portTICK_PERIOD_MS);
     i2c_ssd1306_buffer_clear(&i2c_ssd1306);
+    i2c_ssd1306_async_start(&i2c_ssd1306, SSD1306_FRAME_COALESCE, NULL, NULL);
+}
+
+esp_err_t ssd1306_begin_frame(void)
+{
+    return (i2c_ssd1306_frame_begin(&i2c_ssd1306));
 }
 
 esp_err_t ssd1306_print_str(uint8_t x, uint8_t y, const char *text, bool invert)
@@ -74,9 +85,29 @@ esp_err_t ssd1306_print_str(uint8_t x, uint8_t y, const char *text, bool invert)
     return (i2c_ssd1306_buffer_text(&i2c_ssd1306, x, y, text, invert));
 }
 
+esp_err_t ssd1306_print_str_scaled(uint8_t x, uint8_t y, const char *text, uint8_t scale, bool invert)
+{
+    return (i2c_ssd1306_buffer_text_scaled(&i2c_ssd1306, x, y, text, scale, invert));
+}
+
+esp_err_t ssd1306_print_str_clipped(uint8_t x, uint8_t y, const char *text, uint8_t scale, uint8_t width, bool invert)
+{
+    return (i2c_ssd1306_buffer_text_clipped(&i2c_ssd1306, x, y, text, scale, width, invert));
+}
+
+esp_err_t ssd1306_end_frame(void)
+{
+    return (i2c_ssd1306_frame_end(&i2c_ssd1306));
+}
+
+esp_err_t ssd1306_fill_area(uint8_t x1, uint8_t x2, uint8_t y1, uint8_t y2, bool fill)
+{
+    return (i2c_ssd1306_buffer_fill_space(&i2c_ssd1306, x1, x2, y1, y2, fill));
+}
+
 esp_err_t ssd1306_display(void)
 {
-    return (i2c_ssd1306_buffer_to_ram(&i2c_ssd1306));
+    return (i2c_ssd1306_frame_submit(&i2c_ssd1306));
 }
 
 esp_err_t ssd1306_clear(void)
@@ -84,44 +115,75 @@ esp_err_t ssd1306_clear(void)
     return (i2c_ssd1306_buffer_clear(&i2c_ssd1306));
 }
 
-esp_err_t i2c_ssd1306_init(i2c_master_bus_handle_t i2c_master_bus, i2c_ssd1306_config_t i2c_ssd1306_config, i2c_ssd1306_handle_t *i2c_ssd1306)
+esp_err_t ssd1306_invalidate(void)
 {
-    if (i2c_ssd1306_config.i2c_scl_speed_hz > 400000 || i2c_ssd1306_config.width > 128 || i2c_ssd1306_config.height % 8 != 0 || i2c_ssd1306_config.height < 16 || i2c_ssd1306_config.height > 64)
-    {
-        ESP_LOGE(SSD1306_TAG, "Invalid SSD1306 configuration, 'i2c_scl_speed_hz' must be less than or equal to 400000, 'width' must be less than or equal to 128, 'height' must be between 16 and 64 and multiple of 8");
-        return ESP_ERR_INVALID_ARG;
-    }
+    return (i2c_ssd1306_invalidate(&i2c_ssd1306));
+}
 
-    ESP_LOGI(SSD1306_TAG, "Initializing I2C SSD1306...");
-    esp_err_t ret = i2c_master_probe(i2c_master_bus, i2c_ssd1306_config.i2c_device_address, I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
-    if (ret != ESP_OK)
+esp_err_t ssd1306_get_flush_stats(ssd1306_flush_stats_t *stats)
+{
+    return (i2c_ssd1306_get_flush_stats(&i2c_ssd1306, stats));
+}
+#endif
+
+static esp_err_t i2c_ssd1306_transmit_buffers(i2c_ssd1306_handle_t *i2c_ssd1306, const ssd1306_transport_buffer_t *buffers, size_t total_buffers)
+{
+    esp_err_t err = ssd1306_transport_transmit(&i2c_ssd1306->transport, buffers, total_buffers);
+    if (err == ESP_OK)
     {
-        switch (ret)
+        size_t bytes_sent = 0;
+        for (size_t i = 0; i < total_buffers; i++)
         {
-        case ESP_ERR_NOT_FOUND:
-            ESP_LOGE(SSD1306_TAG, "I2C SSD1306 device not found in address 0x%02X", i2c_ssd1306_config.i2c_device_address);
-            break;
-        case ESP_ERR_TIMEOUT:
-            ESP_LOGE(SSD1306_TAG, "I2C SSD1306 device timeout in address 0x%02X", i2c_ssd1306_config.i2c_device_address);
-            break;
-        default:
-            ESP_LOGE(SSD1306_TAG, "I2C SSD1306 device error in address 0x%02X", i2c_ssd1306_config.i2c_device_address);
-            break;
+            bytes_sent += buffers[i].size;
         }
+        /* The counters are read and reset from other tasks while the flush task transmits. */
+        portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+        i2c_ssd1306->stats.bytes_sent += bytes_sent;
+        i2c_ssd1306->stats.transactions++;
+        portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    }
+
+    return err;
+}
+
+static esp_err_t i2c_ssd1306_transmit(i2c_ssd1306_handle_t *i2c_ssd1306, const uint8_t *data, size_t size)
+{
+    ssd1306_transport_buffer_t buffer = {.data = data, .size = size};
 
+    return i2c_ssd1306_transmit_buffers(i2c_ssd1306, &buffer, 1);
+}
+
+#ifdef ESP_PLATFORM
+esp_err_t i2c_ssd1306_init(i2c_master_bus_handle_t i2c_master_bus, i2c_ssd1306_config_t i2c_ssd1306_config, i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    ESP_LOGI(SSD1306_TAG, "Initializing I2C SSD1306...");
+    ssd1306_transport_t transport;
+    esp_err_t ret = ssd1306_i2c_transport_init(i2c_master_bus, i2c_ssd1306_config.i2c_device_address, i2c_ssd1306_config.i2c_scl_speed_hz, &transport);
+    if (ret != ESP_OK)
         return ret;
-    }
 
-    i2c_device_config_t i2c_device_config = {
-        .dev_addr_length = I2C_ADDR_BIT_7,
-        .device_address = i2c_ssd1306_config.i2c_device_address,
-        .scl_speed_hz = i2c_ssd1306_config.i2c_scl_speed_hz};
-    ret = i2c_master_bus_add_device(i2c_master_bus, &i2c_device_config, &i2c_ssd1306->i2c_master_dev);
+    ret = i2c_ssd1306_init_transport(transport, i2c_ssd1306_config, i2c_ssd1306);
     if (ret != ESP_OK)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to add I2C SSD1306 device");
+        ssd1306_transport_deinit(&transport);
         return ret;
     }
+    ESP_LOGI(SSD1306_TAG, "I2C SSD1306 initialized successfully");
+
+    return ret;
+}
+#endif
+
+esp_err_t i2c_ssd1306_init_transport(ssd1306_transport_t transport, i2c_ssd1306_config_t i2c_ssd1306_config, i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    if (i2c_ssd1306_config.width > 128 || i2c_ssd1306_config.height % 8 != 0 || i2c_ssd1306_config.height < 16 || i2c_ssd1306_config.height > 64)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid SSD1306 configuration, 'width' must be less than or equal to 128, 'height' must be between 16 and 64 and multiple of 8");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    i2c_ssd1306->transport = transport;
+    memset(&i2c_ssd1306->stats, 0, sizeof(i2c_ssd1306->stats));
     uint8_t ssd1306_init_cmd[] = {
         OLED_CONTROL_BYTE_CMD,
         OLED_CMD_DISPLAY_OFF,
@@ -143,30 +205,39 @@ esp_err_t i2c_ssd1306_init(i2c_master_bus_handle_t i2c_master_bus, i2c_ssd1306_c
         ssd1306_init_cmd[7] = OLED_CMD_COM_SCAN_DIRECTION_REMAP;
         ssd1306_init_cmd[8] = OLED_CMD_SEGMENT_REMAP_RIGHT_TO_LEFT;
     }
-    ret = i2c_master_transmit(i2c_ssd1306->i2c_master_dev, ssd1306_init_cmd, sizeof(ssd1306_init_cmd), I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+    if (i2c_ssd1306_config.addr_mode == SSD1306_ADDR_MODE_HORIZONTAL)
+    {
+        ssd1306_init_cmd[12] = 0x00;
+    }
+    esp_err_t ret = i2c_ssd1306_transmit(i2c_ssd1306, ssd1306_init_cmd, sizeof(ssd1306_init_cmd));
     if (ret != ESP_OK)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to initialize I2C SSD1306 device");
+        ESP_LOGE(SSD1306_TAG, "Failed to initialize SSD1306 device");
         return ret;
     }
 
     i2c_ssd1306->width = i2c_ssd1306_config.width;
     i2c_ssd1306->height = i2c_ssd1306_config.height;
     i2c_ssd1306->total_pages = i2c_ssd1306_config.height / 8;
-
-    i2c_ssd1306->page = (ssd1306_page_t *)calloc(i2c_ssd1306->total_pages, sizeof(ssd1306_page_t));
-    if (i2c_ssd1306->page == NULL)
-    {
-        ESP_LOGE(SSD1306_TAG, "Failed to allocate memory for I2C SSD1306 device");
-        return ESP_ERR_NO_MEM;
-    }
+    i2c_ssd1306->addr_mode = i2c_ssd1306_config.addr_mode;
+    i2c_ssd1306->font = &ssd1306_font8x8;
+    memset(i2c_ssd1306->glyph_cache, 0, sizeof(i2c_ssd1306->glyph_cache));
+    i2c_ssd1306->glyph_cache_tick = 0;
+    i2c_ssd1306->glyph_cache_misses = 0;
+
+    i2c_ssd1306->page = i2c_ssd1306->frame[0];
+    i2c_ssd1306->front = i2c_ssd1306->frame[1];
     for (uint8_t i = 0; i < i2c_ssd1306->total_pages; i++)
     {
-        i2c_ssd1306->page[i].segment = (uint8_t *)calloc(i2c_ssd1306->width, sizeof(uint8_t));
-        if (i2c_ssd1306->page[i].segment == NULL)
-            return ESP_ERR_NO_MEM;
+        i2c_ssd1306->page[i].control = OLED_CONTROL_BYTE_DATA;
+        i2c_ssd1306->front[i].control = OLED_CONTROL_BYTE_DATA;
+        memset(i2c_ssd1306->page[i].segment, 0x00, sizeof(i2c_ssd1306->page[i].segment));
     }
-    ESP_LOGI(SSD1306_TAG, "I2C SSD1306 initialized successfully");
+    memset(&i2c_ssd1306->async, 0, sizeof(i2c_ssd1306->async));
+    portMUX_INITIALIZE(&i2c_ssd1306->async.lock);
+    i2c_ssd1306->gram_valid = false;
+    i2c_ssd1306->gram_generation = 0;
+    i2c_ssd1306->scroll_active = false;
 
     return ret;
 }
@@ -174,15 +245,10 @@ esp_err_t i2c_ssd1306_init(i2c_master_bus_handle_t i2c_master_bus, i2c_ssd1306_c
 esp_err_t i2c_ssd1306_deinit(i2c_ssd1306_handle_t *i2c_ssd1306)
 {
     ESP_LOGI(SSD1306_TAG, "Deinitializing I2C SSD1306...");
-    for (uint8_t i = 0; i < i2c_ssd1306->total_pages; i++)
-    {
-        free(i2c_ssd1306->page[i].segment);
-    }
-    free(i2c_ssd1306->page);
-    esp_err_t ret = i2c_master_bus_rm_device(i2c_ssd1306->i2c_master_dev);
+    esp_err_t ret = ssd1306_transport_deinit(&i2c_ssd1306->transport);
     if (ret != ESP_OK)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to remove I2C SSD1306 device");
+        ESP_LOGE(SSD1306_TAG, "Failed to release the SSD1306 transport");
         return ret;
     }
     ESP_LOGI(SSD1306_TAG, "I2C SSD1306 deinitialized successfully");
@@ -290,80 +356,320 @@ esp_err_t i2c_ssd1306_buffer_fill_space(i2c_ssd1306_handle_t *i2c_ssd1306, uint8
     return ESP_OK;
 }
 
-esp_err_t i2c_ssd1306_buffer_text(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, bool invert)
+/* Replicates a byte mask into the eight byte lanes of a word, one lane per display column. */
+#define SSD1306_COLUMN_LANES(mask) (0x0101010101010101ULL * (uint8_t)(mask))
+
+static inline uint64_t i2c_ssd1306_load_columns(const uint8_t *columns)
+{
+    uint64_t word;
+    memcpy(&word, columns, sizeof(word));
+    return word;
+}
+
+static inline void i2c_ssd1306_or_columns(uint8_t *segment, uint64_t word, uint8_t columns)
+{
+    if (columns == 8)
+    {
+        uint64_t current;
+        memcpy(&current, segment, sizeof(current));
+        current |= word;
+        memcpy(segment, &current, sizeof(current));
+        return;
+    }
+
+    uint8_t bytes[8];
+    memcpy(bytes, &word, sizeof(bytes));
+    for (uint8_t j = 0; j < columns; j++)
+    {
+        segment[j] |= bytes[j];
+    }
+}
+
+/* ORs up to eight columns into the buffer at any row. Unaligned rows are split into the two pages by shifting every byte lane at
+   once and masking off the bits that spilled into the neighbouring lane. */
+static inline void i2c_ssd1306_blit_columns(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t page, uint8_t offset, uint8_t x, uint64_t word, uint8_t columns)
+{
+    if (offset == 0)
+    {
+        i2c_ssd1306_or_columns(&i2c_ssd1306->page[page].segment[x], word, columns);
+        return;
+    }
+
+    i2c_ssd1306_or_columns(&i2c_ssd1306->page[page].segment[x], (word << offset) & SSD1306_COLUMN_LANES(0xFF << offset), columns);
+    if (page + 1 < i2c_ssd1306->total_pages)
+    {
+        i2c_ssd1306_or_columns(&i2c_ssd1306->page[page + 1].segment[x], (word >> (8 - offset)) & SSD1306_COLUMN_LANES(0xFF >> (8 - offset)), columns);
+    }
+}
+
+/* Decodes the next UTF-8 code point and advances 'text'. Only one and two byte sequences are needed for Latin-1, anything else
+   decodes to a code point that no font covers and is drawn with the fallback glyph. */
+static uint16_t i2c_ssd1306_next_code_point(const char **text)
+{
+    const uint8_t *c = (const uint8_t *)*text;
+    if (c[0] >= 0xC2 && c[0] <= 0xDF && (c[1] & 0xC0) == 0x80)
+    {
+        *text += 2;
+        return ((c[0] & 0x1F) << 6) | (c[1] & 0x3F);
+    }
+    *text += 1;
+
+    return c[0] < 0x80 ? c[0] : 0xFFFF;
+}
+
+static uint16_t i2c_ssd1306_glyph_index(const ssd1306_font_t *font, uint16_t code_point)
+{
+    for (uint8_t i = 0; i < font->total_ranges; i++)
+    {
+        const ssd1306_font_range_t *range = &font->ranges[i];
+        if (code_point >= range->first && code_point <= range->last)
+            return range->glyph_index + (code_point - range->first);
+    }
+
+    return font->fallback;
+}
+
+static inline uint8_t i2c_ssd1306_glyph_advance(const ssd1306_font_t *font, uint16_t glyph_index)
+{
+    return font->advance ? font->advance[glyph_index] : font->width;
+}
+
+uint16_t i2c_ssd1306_text_width(i2c_ssd1306_handle_t *i2c_ssd1306, const char *text)
+{
+    uint16_t width = 0;
+    while (text && *text != '\0')
+    {
+        width += i2c_ssd1306_glyph_advance(i2c_ssd1306->font, i2c_ssd1306_glyph_index(i2c_ssd1306->font, i2c_ssd1306_next_code_point(&text)));
+    }
+
+    return width;
+}
+
+esp_err_t i2c_ssd1306_set_font(i2c_ssd1306_handle_t *i2c_ssd1306, const ssd1306_font_t *font)
+{
+    if (font == NULL || font->total_ranges == 0 || font->width == 0 || font->width > SSD1306_FONT_CELL_SIZE)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid font, it must have at least one range and a width between 1 and %d", SSD1306_FONT_CELL_SIZE);
+        return ESP_ERR_INVALID_ARG;
+    }
+    i2c_ssd1306->font = font;
+
+    return ESP_OK;
+}
+
+/* Draws text from column 'x' up to, but not including, column 'right', which is at most the display width. Truncation is only
+   logged as a warning when the caller did not ask for 'clip'. */
+static esp_err_t i2c_ssd1306_text_to_buffer(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, uint8_t right, bool clip, bool invert)
 {
-    if (x >= i2c_ssd1306->width || y >= i2c_ssd1306->height || !text || strlen(text) == 0)
+    if (x >= right || y >= i2c_ssd1306->height || !text || text[0] == '\0')
     {
-        ESP_LOGE(SSD1306_TAG, "Invalid text or coordinates: x=%d (max %d), y=%d (max %d)", x, i2c_ssd1306->width - 1, y, i2c_ssd1306->height - 1);
+        ESP_LOGE(SSD1306_TAG, "Invalid text or coordinates: x=%d (max %d), y=%d (max %d)", x, right - 1, y, i2c_ssd1306->height - 1);
         return ESP_ERR_INVALID_ARG;
     }
 
-    uint8_t len = strlen(text);
+    const ssd1306_font_t *font = i2c_ssd1306->font;
     uint8_t page = y / 8;
     uint8_t offset = y % 8;
     bool has_next_page = (page + 1) < i2c_ssd1306->total_pages;
 
-    uint8_t max_chars = (i2c_ssd1306->width - x) / 8;
-    if (len > max_chars)
+    if (offset != 0 && !has_next_page)
     {
-        ESP_LOGW(SSD1306_TAG, "Text truncated: text columns exceed display width, lost %d columns", x + (len * 8) - i2c_ssd1306->width);
+        ESP_LOGW(SSD1306_TAG, "Vertical truncation: text exceeds display height, lost %d rows", offset);
     }
 
-    if (offset != 0 && !has_next_page)
+    /* Each glyph is eight column bytes, handled as one word. */
+    uint8_t clipped_columns = 0;
+    const char *c = text;
+    while (*c != '\0' && x < right)
     {
-        ESP_LOGW(SSD1306_TAG, "Vertical truncation: text exceeds display height, lost %d rows", offset);
+        uint16_t glyph_index = i2c_ssd1306_glyph_index(font, i2c_ssd1306_next_code_point(&c));
+        uint64_t glyph = i2c_ssd1306_load_columns(font->glyphs[glyph_index]);
+        uint8_t advance = i2c_ssd1306_glyph_advance(font, glyph_index);
+        uint8_t available_columns = right - x;
+        uint8_t columns_to_draw = (available_columns < advance) ? available_columns : advance;
+        clipped_columns = advance - columns_to_draw;
+
+        if (invert)
+        {
+            glyph = ~glyph;
+        }
+        i2c_ssd1306_blit_columns(i2c_ssd1306, page, offset, x, glyph, columns_to_draw);
+
+        x += columns_to_draw;
     }
 
-    for (uint8_t i = 0; i < len && x < i2c_ssd1306->width; i++)
+    if (clip && (*c != '\0' || clipped_columns != 0))
+    {
+        ESP_LOGD(SSD1306_TAG, "Text clipped: lost %d columns", i2c_ssd1306_text_width(i2c_ssd1306, c) + clipped_columns);
+    }
+    else if (*c != '\0' || clipped_columns != 0)
     {
-        const uint8_t *char_data = font8x8[(uint8_t)text[i]];
-        uint8_t available_columns = i2c_ssd1306->width - x;
-        uint8_t columns_to_draw = (available_columns < 8) ? available_columns : 8;
+        ESP_LOGW(SSD1306_TAG, "Text truncated: text columns exceed the available width, lost %d columns", i2c_ssd1306_text_width(i2c_ssd1306, c) + clipped_columns);
+    }
+
+    return ESP_OK;
+}
 
-        for (uint8_t j = 0; j < columns_to_draw; j++)
+esp_err_t i2c_ssd1306_buffer_text(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, bool invert)
+{
+    return i2c_ssd1306_text_to_buffer(i2c_ssd1306, x, y, text, i2c_ssd1306->width, false, invert);
+}
+
+/* Spread every bit of a nibble over two or three consecutive bits, to scale glyph columns vertically. */
+static const uint8_t ssd1306_spread2[16] = {
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF};
+static const uint16_t ssd1306_spread3[16] = {
+    0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF, 0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF};
+
+/* Returns the glyph expanded to 'scale', from the cache or expanded into the least recently used entry. The cache is fully
+   associative on (font, glyph, scale), so a readout such as "20.5°" keeps all its glyphs cached whatever their glyph indexes. */
+static const ssd1306_scaled_glyph_t *i2c_ssd1306_scaled_glyph(i2c_ssd1306_handle_t *i2c_ssd1306, uint16_t glyph_index, uint8_t scale)
+{
+    uint32_t tick = ++i2c_ssd1306->glyph_cache_tick;
+    ssd1306_scaled_glyph_t *cached = &i2c_ssd1306->glyph_cache[0];
+    for (uint8_t i = 0; i < SSD1306_GLYPH_CACHE_SIZE; i++)
+    {
+        ssd1306_scaled_glyph_t *entry = &i2c_ssd1306->glyph_cache[i];
+        if (entry->scale == scale && entry->font == i2c_ssd1306->font && entry->glyph_index == glyph_index)
         {
-            uint8_t char_col = char_data[j];
+            entry->last_used = tick;
+            return entry;
+        }
+        /* Ticks wrap, so the oldest entry is the one furthest behind the current tick */
+        if (entry->scale == 0 || (cached->scale != 0 && tick - entry->last_used > tick - cached->last_used))
+            cached = entry;
+    }
 
-            if (invert)
-            {
-                char_col = ~char_col;
-            }
+    i2c_ssd1306->glyph_cache_misses++;
+    const uint8_t *columns = i2c_ssd1306->font->glyphs[glyph_index];
+    for (uint8_t col = 0; col < SSD1306_FONT_CELL_SIZE; col++)
+    {
+        uint8_t low = columns[col] & 0x0F;
+        uint8_t high = columns[col] >> 4;
+        uint32_t spread = (scale == 2) ? (ssd1306_spread2[low] | ssd1306_spread2[high] << 8) : (ssd1306_spread3[low] | ssd1306_spread3[high] << 12);
+        for (uint8_t page = 0; page < scale; page++)
+        {
+            memset(&cached->page[page][col * scale], (uint8_t)(spread >> (page * 8)), scale);
+        }
+    }
+    cached->font = i2c_ssd1306->font;
+    cached->glyph_index = glyph_index;
+    cached->scale = scale;
+    cached->last_used = tick;
 
-            if (offset == 0)
-            {
-                i2c_ssd1306->page[page].segment[x + j] |= char_col;
-            }
-            else
-            {
-                uint8_t lower_part = char_col << offset;
-                uint8_t upper_part = char_col >> (8 - offset);
+    return cached;
+}
 
-                i2c_ssd1306->page[page].segment[x + j] |= lower_part;
-                if (has_next_page)
+/* Scaled counterpart of i2c_ssd1306_text_to_buffer(), clipped at column 'right' the same way. */
+static esp_err_t i2c_ssd1306_text_scaled_to_buffer(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, uint8_t scale, uint8_t right, bool clip, bool invert)
+{
+    if (scale == 0 || scale > SSD1306_TEXT_MAX_SCALE)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid text scale, must be between 1 and %d", SSD1306_TEXT_MAX_SCALE);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (scale == 1)
+        return i2c_ssd1306_text_to_buffer(i2c_ssd1306, x, y, text, right, clip, invert);
+    if (x >= right || y >= i2c_ssd1306->height || !text || text[0] == '\0')
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid text or coordinates: x=%d (max %d), y=%d (max %d)", x, right - 1, y, i2c_ssd1306->height - 1);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const ssd1306_font_t *font = i2c_ssd1306->font;
+    uint8_t page = y / 8;
+    uint8_t offset = y % 8;
+    uint8_t glyph_height = SSD1306_FONT_CELL_SIZE * scale;
+    if (y + glyph_height > i2c_ssd1306->height)
+    {
+        ESP_LOGW(SSD1306_TAG, "Vertical truncation: text exceeds display height, lost %d rows", y + glyph_height - i2c_ssd1306->height);
+    }
+
+    /* Every page of a scaled glyph is blitted eight columns at a time, like an unscaled glyph. */
+    uint16_t clipped_columns = 0;
+    const char *c = text;
+    while (*c != '\0' && x < right)
+    {
+        uint16_t glyph_index = i2c_ssd1306_glyph_index(font, i2c_ssd1306_next_code_point(&c));
+        const ssd1306_scaled_glyph_t *glyph = i2c_ssd1306_scaled_glyph(i2c_ssd1306, glyph_index, scale);
+        uint8_t advance = i2c_ssd1306_glyph_advance(font, glyph_index) * scale;
+        uint8_t available_columns = right - x;
+        uint8_t columns_to_draw = (available_columns < advance) ? available_columns : advance;
+        clipped_columns = advance - columns_to_draw;
+
+        for (uint8_t i = 0; i < scale && page + i < i2c_ssd1306->total_pages; i++)
+        {
+            for (uint8_t col = 0; col < columns_to_draw; col += 8)
+            {
+                uint64_t word = i2c_ssd1306_load_columns(&glyph->page[i][col]);
+                if (invert)
                 {
-                    i2c_ssd1306->page[page + 1].segment[x + j] |= upper_part;
+                    word = ~word;
                 }
+                i2c_ssd1306_blit_columns(i2c_ssd1306, page + i, offset, x + col, word, (columns_to_draw - col < 8) ? columns_to_draw - col : 8);
             }
         }
 
-        x += 8;
+        x += columns_to_draw;
+    }
+
+    if (clip && (*c != '\0' || clipped_columns != 0))
+    {
+        ESP_LOGD(SSD1306_TAG, "Text clipped: lost %d columns", i2c_ssd1306_text_width(i2c_ssd1306, c) * scale + clipped_columns);
+    }
+    else if (*c != '\0' || clipped_columns != 0)
+    {
+        ESP_LOGW(SSD1306_TAG, "Text truncated: text columns exceed the available width, lost %d columns", i2c_ssd1306_text_width(i2c_ssd1306, c) * scale + clipped_columns);
     }
 
     return ESP_OK;
 }
 
+esp_err_t i2c_ssd1306_buffer_text_scaled(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, uint8_t scale, bool invert)
+{
+    return i2c_ssd1306_text_scaled_to_buffer(i2c_ssd1306, x, y, text, scale, i2c_ssd1306->width, false, invert);
+}
+
+esp_err_t i2c_ssd1306_buffer_text_clipped(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, uint8_t scale, uint8_t width, bool invert)
+{
+    if (x >= i2c_ssd1306->width || width == 0)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid clip: x=%d (max %d), width=%d (min 1)", x, i2c_ssd1306->width - 1, width);
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t right = (width < i2c_ssd1306->width - x) ? x + width : i2c_ssd1306->width;
+
+    return i2c_ssd1306_text_scaled_to_buffer(i2c_ssd1306, x, y, text, scale, right, true, invert);
+}
+
 esp_err_t i2c_ssd1306_buffer_int(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, int value, bool invert)
 {
     char text[16];
-    sprintf(text, "%d", value);
+    num_format(text, sizeof(text), value, NULL);
 
     return i2c_ssd1306_buffer_text(i2c_ssd1306, x, y, text, invert);
 }
 
 esp_err_t i2c_ssd1306_buffer_float(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, float value, uint8_t decimals, bool invert)
 {
+    /* Scaled to a fixed-point integer so no float formatting code is needed. */
+    static const int32_t powers_of_ten[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    if (decimals >= sizeof(powers_of_ten) / sizeof(powers_of_ten[0]))
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid number of decimals, it must be less than %d", (int)(sizeof(powers_of_ten) / sizeof(powers_of_ten[0])));
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    float scaled = value * powers_of_ten[decimals];
+    if (!(scaled > -2147483520.0f && scaled < 2147483520.0f))
+    {
+        ESP_LOGE(SSD1306_TAG, "Value out of range for %d decimals", decimals);
+        return ESP_ERR_INVALID_ARG;
+    }
+
     char text[16];
-    sprintf(text, "%.*f", decimals, value);
+    num_format_t format = {.decimals = decimals};
+    num_format(text, sizeof(text), (int32_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f), &format);
 
     return i2c_ssd1306_buffer_text(i2c_ssd1306, x, y, text, invert);
 }
@@ -426,71 +732,159 @@ esp_err_t i2c_ssd1306_buffer_image(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x,
     return ESP_OK;
 }
 
-esp_err_t i2c_ssd1306_segment_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t page, uint8_t segment)
+static esp_err_t i2c_ssd1306_set_ram_window(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t initial_page, uint8_t final_page, uint8_t initial_segment, uint8_t final_segment)
 {
-    if (page >= i2c_ssd1306->total_pages || segment >= i2c_ssd1306->width)
+    if (i2c_ssd1306->addr_mode == SSD1306_ADDR_MODE_HORIZONTAL)
     {
-        ESP_LOGE(SSD1306_TAG, "Invalid page or segment number, 'page' must be between 0 and %d, 'segment' must be between 0 and %d", i2c_ssd1306->total_pages - 1, i2c_ssd1306->width - 1);
-        return ESP_ERR_INVALID_ARG;
+        uint8_t ram_window_cmd[] = {
+            OLED_CONTROL_BYTE_CMD,
+            OLED_CMD_SET_COLUMN_ADDR_RANGE, initial_segment, final_segment,
+            OLED_CMD_SET_PAGE_ADDR_RANGE, initial_page, final_page};
+        return i2c_ssd1306_transmit(i2c_ssd1306, ram_window_cmd, sizeof(ram_window_cmd));
     }
 
     uint8_t ram_addr_cmd[] = {
         OLED_CONTROL_BYTE_CMD,
-        OLED_MASK_PAGE_ADDR | page,
-        OLED_MASK_LSB_NIBBLE_SEG_ADDR | (segment & 0x0F),
-        OLED_MASK_HSB_NIBBLE_SEG_ADDR | (segment >> 4 & 0x0F)};
-    esp_err_t err = i2c_master_transmit(i2c_ssd1306->i2c_master_dev, ram_addr_cmd, sizeof(ram_addr_cmd), I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+        OLED_MASK_PAGE_ADDR | initial_page,
+        OLED_MASK_LSB_NIBBLE_SEG_ADDR | (initial_segment & 0x0F),
+        OLED_MASK_HSB_NIBBLE_SEG_ADDR | (initial_segment >> 4 & 0x0F)};
+    return i2c_ssd1306_transmit(i2c_ssd1306, ram_addr_cmd, sizeof(ram_addr_cmd));
+}
+
+static esp_err_t i2c_ssd1306_window_data_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_page_t *frame, uint8_t initial_page, uint8_t final_page, uint8_t initial_segment, uint8_t final_segment)
+{
+    uint8_t segments = final_segment - initial_segment + 1;
+    esp_err_t err;
+    if (initial_page == final_page && initial_segment == 0)
+    {
+        /* The reserved control byte sits right before segment 0, so the page goes out straight from the buffer. */
+        err = i2c_ssd1306_transmit(i2c_ssd1306, &frame[initial_page].control, segments + 1);
+    }
+    else
+    {
+        ssd1306_transport_buffer_t ram_data_buffers[1 + SSD1306_MAX_PAGES];
+        size_t total_buffers = 0;
+        ram_data_buffers[total_buffers++] = (ssd1306_transport_buffer_t){.data = &frame[initial_page].control, .size = 1};
+        for (uint8_t i = initial_page; i <= final_page; i++)
+        {
+            ram_data_buffers[total_buffers++] = (ssd1306_transport_buffer_t){.data = &frame[i].segment[initial_segment], .size = segments};
+        }
+        err = i2c_ssd1306_transmit_buffers(i2c_ssd1306, ram_data_buffers, total_buffers);
+    }
     if (err != ESP_OK)
+        return err;
+
+    for (uint8_t i = initial_page; i <= final_page; i++)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to address the segment to the RAM of the SSD1306 device");
+        memcpy(&i2c_ssd1306->gram[i][initial_segment], &frame[i].segment[initial_segment], segments);
+    }
+
+    return err;
+}
+
+static bool i2c_ssd1306_scrolling(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    bool scrolling = i2c_ssd1306->scroll_active;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+
+    return scrolling;
+}
+
+static esp_err_t i2c_ssd1306_frame_window_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_page_t *frame, uint8_t initial_page, uint8_t final_page, uint8_t initial_segment, uint8_t final_segment)
+{
+    /* The controller would scroll the new data along with the rest, leaving the shadow copy out of step with the display. */
+    if (i2c_ssd1306_scrolling(i2c_ssd1306))
+    {
+        ESP_LOGE(SSD1306_TAG, "Frames cannot be transferred while the SSD1306 device is scrolling, stop scrolling first");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err = ESP_OK;
+    if (i2c_ssd1306->addr_mode == SSD1306_ADDR_MODE_PAGE && initial_page != final_page)
+    {
+        for (uint8_t i = initial_page; i <= final_page; i++)
+        {
+            err = i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, frame, i, i, initial_segment, final_segment);
+            if (err != ESP_OK)
+                return err;
+        }
+
+        return err;
+    }
+
+    err = i2c_ssd1306_set_ram_window(i2c_ssd1306, initial_page, final_page, initial_segment, final_segment);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(SSD1306_TAG, "Failed to address the window to the RAM of the SSD1306 device");
         return err;
     }
-    uint8_t ram_data_cmd[] = {
-        OLED_CONTROL_BYTE_DATA,
-        i2c_ssd1306->page[page].segment[segment]};
-    err = i2c_master_transmit(i2c_ssd1306->i2c_master_dev, ram_data_cmd, sizeof(ram_data_cmd), I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+    /* In horizontal mode the column pointer wraps to the next page at 'final_segment', so all page slices go in one transaction. */
+    err = i2c_ssd1306_window_data_to_ram(i2c_ssd1306, frame, initial_page, final_page, initial_segment, final_segment);
     if (err != ESP_OK)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to transfer the segment to the RAM of the SSD1306 device");
+        ESP_LOGE(SSD1306_TAG, "Failed to transfer the window to the RAM of the SSD1306 device");
         return err;
     }
 
     return err;
 }
 
-esp_err_t i2c_ssd1306_segments_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t page, uint8_t initial_segment, uint8_t final_segment)
+static void i2c_ssd1306_flush_latency(i2c_ssd1306_handle_t *i2c_ssd1306, int64_t start_us)
 {
-    if (page >= i2c_ssd1306->total_pages || initial_segment >= i2c_ssd1306->width || final_segment >= i2c_ssd1306->width || initial_segment > final_segment)
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    i2c_ssd1306->stats.flushes++;
+    i2c_ssd1306->stats.last_flush_us = elapsed_us;
+    i2c_ssd1306->stats.total_flush_us += elapsed_us;
+    if (elapsed_us > i2c_ssd1306->stats.max_flush_us)
+        i2c_ssd1306->stats.max_flush_us = elapsed_us;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    ESP_LOGD(SSD1306_TAG, "Flush took %" PRIu32 " us in %s addressing mode", elapsed_us, i2c_ssd1306->addr_mode == SSD1306_ADDR_MODE_HORIZONTAL ? "horizontal" : "page");
+}
+
+esp_err_t i2c_ssd1306_set_addr_mode(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_addr_mode_t addr_mode)
+{
+    if (addr_mode != SSD1306_ADDR_MODE_PAGE && addr_mode != SSD1306_ADDR_MODE_HORIZONTAL)
     {
-        ESP_LOGE(SSD1306_TAG, "Invalid page or segment range, 'page' must be between 0 and %d, 'initial_segment' and 'final_segment' must be between 0 and %d, 'initial_segment' must be less than or equal to 'final_segment'", i2c_ssd1306->total_pages - 1, i2c_ssd1306->width - 1);
+        ESP_LOGE(SSD1306_TAG, "Invalid addressing mode, must be SSD1306_ADDR_MODE_PAGE or SSD1306_ADDR_MODE_HORIZONTAL");
         return ESP_ERR_INVALID_ARG;
     }
 
-    uint8_t ram_addr_cmd[] = {
+    uint8_t addr_mode_cmd[] = {
         OLED_CONTROL_BYTE_CMD,
-        OLED_MASK_PAGE_ADDR | page,
-        OLED_MASK_LSB_NIBBLE_SEG_ADDR | (initial_segment & 0x0F),
-        OLED_MASK_HSB_NIBBLE_SEG_ADDR | (initial_segment >> 4 & 0x0F)};
-    esp_err_t err = i2c_master_transmit(i2c_ssd1306->i2c_master_dev, ram_addr_cmd, sizeof(ram_addr_cmd), I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+        OLED_CMD_SET_MEMORY_ADDR_MODE, addr_mode == SSD1306_ADDR_MODE_HORIZONTAL ? 0x00 : 0x02};
+    esp_err_t err = i2c_ssd1306_transmit(i2c_ssd1306, addr_mode_cmd, sizeof(addr_mode_cmd));
     if (err != ESP_OK)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to address the initial segment to the RAM of the SSD1306 device");
+        ESP_LOGE(SSD1306_TAG, "Failed to set the addressing mode of the SSD1306 device");
         return err;
     }
-    uint8_t ram_data_cmd[final_segment - initial_segment + 2];
-    ram_data_cmd[0] = OLED_CONTROL_BYTE_DATA;
-    for (uint8_t i = 0; i < final_segment - initial_segment + 1; i++)
+    i2c_ssd1306->addr_mode = addr_mode;
+
+    return err;
+}
+
+esp_err_t i2c_ssd1306_segment_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t page, uint8_t segment)
+{
+    if (page >= i2c_ssd1306->total_pages || segment >= i2c_ssd1306->width)
     {
-        ram_data_cmd[i + 1] = i2c_ssd1306->page[page].segment[initial_segment + i];
+        ESP_LOGE(SSD1306_TAG, "Invalid page or segment number, 'page' must be between 0 and %d, 'segment' must be between 0 and %d", i2c_ssd1306->total_pages - 1, i2c_ssd1306->width - 1);
+        return ESP_ERR_INVALID_ARG;
     }
-    err = i2c_master_transmit(i2c_ssd1306->i2c_master_dev, ram_data_cmd, sizeof(ram_data_cmd), I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
-    if (err != ESP_OK)
+
+    return i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, i2c_ssd1306->page, page, page, segment, segment);
+}
+
+esp_err_t i2c_ssd1306_segments_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t page, uint8_t initial_segment, uint8_t final_segment)
+{
+    if (page >= i2c_ssd1306->total_pages || initial_segment >= i2c_ssd1306->width || final_segment >= i2c_ssd1306->width || initial_segment > final_segment)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to transfer the segments to the RAM of the SSD1306 device");
-        return err;
+        ESP_LOGE(SSD1306_TAG, "Invalid page or segment range, 'page' must be between 0 and %d, 'initial_segment' and 'final_segment' must be between 0 and %d, 'initial_segment' must be less than or equal to 'final_segment'", i2c_ssd1306->total_pages - 1, i2c_ssd1306->width - 1);
+        return ESP_ERR_INVALID_ARG;
     }
 
-    return err;
+    return i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, i2c_ssd1306->page, page, page, initial_segment, final_segment);
 }
 
 esp_err_t i2c_ssd1306_page_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t page)
@@ -501,61 +895,473 @@ esp_err_t i2c_ssd1306_page_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t pag
         return ESP_ERR_INVALID_ARG;
     }
 
-    uint8_t ram_addr_cmd[] = {
+    return i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, i2c_ssd1306->page, page, page, 0, i2c_ssd1306->width - 1);
+}
+
+esp_err_t i2c_ssd1306_window_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t initial_page, uint8_t final_page, uint8_t initial_segment, uint8_t final_segment)
+{
+    if (initial_page >= i2c_ssd1306->total_pages || final_page >= i2c_ssd1306->total_pages || initial_page > final_page || initial_segment >= i2c_ssd1306->width || final_segment >= i2c_ssd1306->width || initial_segment > final_segment)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid window, 'initial_page' and 'final_page' must be between 0 and %d, 'initial_segment' and 'final_segment' must be between 0 and %d, initial values must be less than or equal to final values", i2c_ssd1306->total_pages - 1, i2c_ssd1306->width - 1);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, i2c_ssd1306->page, initial_page, final_page, initial_segment, final_segment);
+}
+
+esp_err_t i2c_ssd1306_pages_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t initial_page, uint8_t final_page)
+{
+    if (initial_page >= i2c_ssd1306->total_pages || final_page >= i2c_ssd1306->total_pages || initial_page > final_page)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid page range, 'initial_page' and 'final_page' must be between 0 and %d, 'initial_page' must be less than or equal to 'final_page'", i2c_ssd1306->total_pages - 1);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, i2c_ssd1306->page, initial_page, final_page, 0, i2c_ssd1306->width - 1);
+}
+
+static esp_err_t i2c_ssd1306_frame_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_page_t *frame)
+{
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    uint32_t gram_generation = i2c_ssd1306->gram_generation;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, frame, 0, i2c_ssd1306->total_pages - 1, 0, i2c_ssd1306->width - 1);
+    if (err != ESP_OK)
+        return err;
+    /* An invalidation that arrived during the transfer may have reset the display behind it, so the shadow stays invalid and the next
+       flush sends everything again. */
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    if (i2c_ssd1306->gram_generation == gram_generation)
+        i2c_ssd1306->gram_valid = true;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    i2c_ssd1306_flush_latency(i2c_ssd1306, start_us);
+
+    return err;
+}
+
+static esp_err_t i2c_ssd1306_frame_diff_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_page_t *frame)
+{
+    /* Read under the lock the invalidation writes it with. An invalidation after this point leaves 'gram_valid' false, so the next
+       flush is a full one. */
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    bool gram_valid = i2c_ssd1306->gram_valid;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    if (!gram_valid)
+        return i2c_ssd1306_frame_to_ram(i2c_ssd1306, frame);
+
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = ESP_OK;
+    uint32_t bytes_skipped = 0;
+    for (uint8_t i = 0; i < i2c_ssd1306->total_pages; i++)
+    {
+        const uint8_t *segment = frame[i].segment;
+        const uint8_t *gram = i2c_ssd1306->gram[i];
+        uint8_t resent = 0;
+        uint8_t j = 0;
+        while (j < i2c_ssd1306->width)
+        {
+            if (segment[j] == gram[j])
+            {
+                j++;
+                continue;
+            }
+
+            /* Extend the run while the unchanged gap after its last changed segment is cheaper to resend than to readdress. */
+            uint8_t initial_segment = j;
+            uint8_t final_segment = j;
+            for (uint8_t k = j + 1; k < i2c_ssd1306->width && k - final_segment <= SSD1306_DIFF_MERGE_GAP; k++)
+            {
+                if (segment[k] != gram[k])
+                    final_segment = k;
+            }
+
+            err = i2c_ssd1306_frame_window_to_ram(i2c_ssd1306, frame, i, i, initial_segment, final_segment);
+            if (err != ESP_OK)
+            {
+                portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+                i2c_ssd1306->gram_valid = false;
+                i2c_ssd1306->stats.bytes_skipped += bytes_skipped;
+                portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+                return err;
+            }
+            resent += final_segment - initial_segment + 1;
+            j = final_segment + 1;
+        }
+        bytes_skipped += i2c_ssd1306->width - resent;
+    }
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    i2c_ssd1306->stats.bytes_skipped += bytes_skipped;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    i2c_ssd1306_flush_latency(i2c_ssd1306, start_us);
+
+    return err;
+}
+
+esp_err_t i2c_ssd1306_buffer_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    return i2c_ssd1306_frame_to_ram(i2c_ssd1306, i2c_ssd1306->page);
+}
+
+esp_err_t i2c_ssd1306_buffer_diff_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    return i2c_ssd1306_frame_diff_to_ram(i2c_ssd1306, i2c_ssd1306->page);
+}
+
+/* Notification bits of the flush task */
+#define SSD1306_NOTIFY_FRAME (1 << 0)   /* A submitted frame was swapped into the front buffer */
+#define SSD1306_NOTIFY_PENDING (1 << 1) /* A coalesced frame may be waiting for the frame lock */
+
+/* Takes the bus from the flush task for a command sequence, waiting for a frame transfer in progress to finish. Frames submitted
+   meanwhile are handled by the frame policy and sent by i2c_ssd1306_command_end(). Does nothing without the asynchronous flush. */
+static void i2c_ssd1306_command_begin(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    if (i2c_ssd1306->async.task == NULL)
+        return;
+
+    while (1)
+    {
+        portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+        bool claimed = !i2c_ssd1306->async.busy;
+        if (claimed)
+            i2c_ssd1306->async.busy = true;
+        portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+        if (claimed)
+            return;
+        vTaskDelay(1);
+    }
+}
+
+static void i2c_ssd1306_command_end(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    if (i2c_ssd1306->async.task == NULL)
+        return;
+
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    i2c_ssd1306->async.busy = false;
+    bool pending = i2c_ssd1306->async.pending;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    if (pending)
+        xTaskNotify(i2c_ssd1306->async.task, SSD1306_NOTIFY_PENDING, eSetBits);
+}
+
+static esp_err_t i2c_ssd1306_scroll_setup(i2c_ssd1306_handle_t *i2c_ssd1306, const uint8_t *scroll_cmd, size_t size)
+{
+    /* The scroll setup is only accepted while scrolling is deactivated. */
+    uint8_t deactivate_cmd[] = {
         OLED_CONTROL_BYTE_CMD,
-        OLED_MASK_PAGE_ADDR | page,
-        OLED_MASK_LSB_NIBBLE_SEG_ADDR | (0x00 & 0x0F),
-        OLED_MASK_HSB_NIBBLE_SEG_ADDR | (0x00 >> 4 & 0x0F)};
-    esp_err_t err = i2c_master_transmit(i2c_ssd1306->i2c_master_dev, ram_addr_cmd, sizeof(ram_addr_cmd), I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+        OLED_CMD_DEACTIVATE_SCROLL};
+    i2c_ssd1306_command_begin(i2c_ssd1306);
+    esp_err_t err = i2c_ssd1306_transmit(i2c_ssd1306, deactivate_cmd, sizeof(deactivate_cmd));
+    if (err == ESP_OK)
+        err = i2c_ssd1306_transmit(i2c_ssd1306, scroll_cmd, size);
+    if (err == ESP_OK)
+    {
+        portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+        i2c_ssd1306->scroll_active = true;
+        portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    }
+    i2c_ssd1306_command_end(i2c_ssd1306);
     if (err != ESP_OK)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to address the page to the RAM of the SSD1306 device");
+        ESP_LOGE(SSD1306_TAG, "Failed to start scrolling the SSD1306 device");
         return err;
     }
-    uint8_t ram_data_cmd[i2c_ssd1306->width + 1];
-    ram_data_cmd[0] = OLED_CONTROL_BYTE_DATA;
-    for (uint8_t i = 0; i < i2c_ssd1306->width; i++)
+
+    return err;
+}
+
+esp_err_t i2c_ssd1306_scroll_horizontal(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_scroll_dir_t direction, uint8_t initial_page, uint8_t final_page, ssd1306_scroll_interval_t interval)
+{
+    if (initial_page >= i2c_ssd1306->total_pages || final_page >= i2c_ssd1306->total_pages || initial_page > final_page || interval > 0x07)
     {
-        ram_data_cmd[i + 1] = i2c_ssd1306->page[page].segment[i];
+        ESP_LOGE(SSD1306_TAG, "Invalid scroll, 'initial_page' and 'final_page' must be between 0 and %d, 'initial_page' must be less than or equal to 'final_page'", i2c_ssd1306->total_pages - 1);
+        return ESP_ERR_INVALID_ARG;
     }
-    err = i2c_master_transmit(i2c_ssd1306->i2c_master_dev, ram_data_cmd, sizeof(ram_data_cmd), I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+
+    uint8_t scroll_cmd[] = {
+        OLED_CONTROL_BYTE_CMD,
+        direction == SSD1306_SCROLL_LEFT ? OLED_CMD_LEFT_HORIZONTAL_SCROLL : OLED_CMD_RIGHT_HORIZONTAL_SCROLL,
+        0x00, initial_page, interval, final_page, 0x00, 0xFF,
+        OLED_CMD_ACTIVATE_SCROLL};
+
+    return i2c_ssd1306_scroll_setup(i2c_ssd1306, scroll_cmd, sizeof(scroll_cmd));
+}
+
+esp_err_t i2c_ssd1306_scroll_diagonal(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_scroll_dir_t direction, uint8_t initial_page, uint8_t final_page, ssd1306_scroll_interval_t interval, uint8_t vertical_offset)
+{
+    if (initial_page >= i2c_ssd1306->total_pages || final_page >= i2c_ssd1306->total_pages || initial_page > final_page || interval > 0x07 || vertical_offset == 0 || vertical_offset >= i2c_ssd1306->height)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid scroll, 'initial_page' and 'final_page' must be between 0 and %d, 'initial_page' must be less than or equal to 'final_page', 'vertical_offset' must be between 1 and %d", i2c_ssd1306->total_pages - 1, i2c_ssd1306->height - 1);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t scroll_cmd[] = {
+        OLED_CONTROL_BYTE_CMD,
+        OLED_CMD_SET_VERTICAL_SCROLL_AREA, 0x00, i2c_ssd1306->height,
+        direction == SSD1306_SCROLL_LEFT ? OLED_CMD_VERTICAL_LEFT_HORIZONTAL_SCROLL : OLED_CMD_VERTICAL_RIGHT_HORIZONTAL_SCROLL,
+        0x00, initial_page, interval, final_page, vertical_offset,
+        OLED_CMD_ACTIVATE_SCROLL};
+
+    return i2c_ssd1306_scroll_setup(i2c_ssd1306, scroll_cmd, sizeof(scroll_cmd));
+}
+
+esp_err_t i2c_ssd1306_scroll_stop(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    uint8_t deactivate_cmd[] = {
+        OLED_CONTROL_BYTE_CMD,
+        OLED_CMD_DEACTIVATE_SCROLL};
+    i2c_ssd1306_command_begin(i2c_ssd1306);
+    esp_err_t err = i2c_ssd1306_transmit(i2c_ssd1306, deactivate_cmd, sizeof(deactivate_cmd));
+    if (err == ESP_OK)
+    {
+        /* Frames deferred while scrolling go out with the command_end notification, as a full flush. */
+        i2c_ssd1306_invalidate(i2c_ssd1306);
+        portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+        i2c_ssd1306->scroll_active = false;
+        portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    }
+    i2c_ssd1306_command_end(i2c_ssd1306);
     if (err != ESP_OK)
     {
-        ESP_LOGE(SSD1306_TAG, "Failed to transfer the page to the RAM of the SSD1306 device");
+        ESP_LOGE(SSD1306_TAG, "Failed to stop scrolling the SSD1306 device");
         return err;
     }
 
     return err;
 }
 
-esp_err_t i2c_ssd1306_pages_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t initial_page, uint8_t final_page)
+esp_err_t i2c_ssd1306_set_start_line(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t line)
 {
-    if (initial_page >= i2c_ssd1306->total_pages || final_page >= i2c_ssd1306->total_pages || initial_page > final_page)
+    if (line > 63)
     {
-        ESP_LOGE(SSD1306_TAG, "Invalid page range, 'initial_page' and 'final_page' must be between 0 and %d, 'initial_page' must be less than or equal to 'final_page'", i2c_ssd1306->total_pages - 1);
+        ESP_LOGE(SSD1306_TAG, "Invalid start line, must be between 0 and 63");
         return ESP_ERR_INVALID_ARG;
     }
 
-    esp_err_t err = ESP_OK;
-    for (uint8_t i = initial_page; i <= final_page; i++)
+    uint8_t start_line_cmd[] = {
+        OLED_CONTROL_BYTE_CMD,
+        OLED_MASK_DISPLAY_START_LINE | line};
+    i2c_ssd1306_command_begin(i2c_ssd1306);
+    esp_err_t err = i2c_ssd1306_transmit(i2c_ssd1306, start_line_cmd, sizeof(start_line_cmd));
+    i2c_ssd1306_command_end(i2c_ssd1306);
+    if (err != ESP_OK)
     {
-        esp_err_t err = i2c_ssd1306_page_to_ram(i2c_ssd1306, i);
-        if (err != ESP_OK)
-            return err;
+        ESP_LOGE(SSD1306_TAG, "Failed to set the start line of the SSD1306 device");
+        return err;
     }
 
     return err;
 }
 
-esp_err_t i2c_ssd1306_buffer_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306)
+esp_err_t i2c_ssd1306_invalidate(i2c_ssd1306_handle_t *i2c_ssd1306)
 {
-    esp_err_t err = ESP_OK;
-    for (uint8_t i = 0; i < i2c_ssd1306->total_pages; i++)
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    i2c_ssd1306->gram_valid = false;
+    i2c_ssd1306->gram_generation++;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_ssd1306_get_flush_stats(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_flush_stats_t *stats)
+{
+    if (stats == NULL)
     {
-        err = i2c_ssd1306_page_to_ram(i2c_ssd1306, i);
-        if (err != ESP_OK)
-            return err;
+        ESP_LOGE(SSD1306_TAG, "Invalid stats pointer");
+        return ESP_ERR_INVALID_ARG;
     }
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    *stats = i2c_ssd1306->stats;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
 
-    return err;
-}
\ No newline at end of file
+    return ESP_OK;
+}
+
+/* Swaps the back and front buffers and carries the new front frame over to the back buffer, so drawing can continue on top of the
+   last submitted frame. Must be called with the frame lock held and the flush task idle. */
+static void i2c_ssd1306_async_swap(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    ssd1306_page_t *front = i2c_ssd1306->page;
+    i2c_ssd1306->page = i2c_ssd1306->front;
+    i2c_ssd1306->front = front;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    memcpy(i2c_ssd1306->page, i2c_ssd1306->front, i2c_ssd1306->total_pages * sizeof(ssd1306_page_t));
+}
+
+static void i2c_ssd1306_async_task(void *pvParameter)
+{
+    i2c_ssd1306_handle_t *i2c_ssd1306 = (i2c_ssd1306_handle_t *)pvParameter;
+
+    while (1)
+    {
+        uint32_t notified = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &notified, portMAX_DELAY);
+
+        /* A submit that swapped a frame in also set 'busy' for the task. A wake for a pending frame alone does not, and then the task
+           only takes the frame if no submitted one is on its way. */
+        bool owner = (notified & SSD1306_NOTIFY_FRAME) != 0;
+        bool flushing = owner;
+        while (1)
+        {
+            if (flushing)
+            {
+                /* While the display scrolls the frame is deferred: it stays pending until i2c_ssd1306_scroll_stop() wakes the task. */
+                portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+                bool scrolling = i2c_ssd1306->scroll_active;
+                if (scrolling)
+                {
+                    i2c_ssd1306->async.pending = true;
+                    i2c_ssd1306->async.busy = false;
+                }
+                portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+                if (scrolling)
+                    break;
+
+                esp_err_t err = i2c_ssd1306_frame_diff_to_ram(i2c_ssd1306, i2c_ssd1306->front);
+                if (err != ESP_OK)
+                    ESP_LOGE(SSD1306_TAG, "Asynchronous flush failed: %s", esp_err_to_name(err));
+                if (i2c_ssd1306->async.on_frame_done)
+                    i2c_ssd1306->async.on_frame_done(i2c_ssd1306, err, i2c_ssd1306->async.user_ctx);
+            }
+
+            /* A frame submitted while the bus was busy is picked up right away, unless the application is drawing. Then it stays
+               pending, and the application's next submit or i2c_ssd1306_frame_end() notifies the task to pick it up once the frame
+               lock is free again. */
+            flushing = false;
+            if (xSemaphoreTake(i2c_ssd1306->async.frame_lock, 0) == pdTRUE)
+            {
+                portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+                if (i2c_ssd1306->async.pending && (owner || !i2c_ssd1306->async.busy))
+                {
+                    i2c_ssd1306->async.pending = false;
+                    i2c_ssd1306->async.busy = true;
+                    owner = true;
+                    flushing = true;
+                }
+                portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+                if (flushing)
+                    i2c_ssd1306_async_swap(i2c_ssd1306);
+                xSemaphoreGive(i2c_ssd1306->async.frame_lock);
+            }
+            if (flushing)
+                continue;
+
+            if (owner)
+            {
+                portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+                i2c_ssd1306->async.busy = false;
+                portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+            }
+            break;
+        }
+    }
+}
+
+esp_err_t i2c_ssd1306_async_start(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_frame_policy_t policy, ssd1306_frame_done_cb_t on_frame_done, void *user_ctx)
+{
+    if (policy != SSD1306_FRAME_DROP && policy != SSD1306_FRAME_COALESCE)
+    {
+        ESP_LOGE(SSD1306_TAG, "Invalid frame policy, must be SSD1306_FRAME_DROP or SSD1306_FRAME_COALESCE");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (i2c_ssd1306->async.task != NULL)
+    {
+        ESP_LOGE(SSD1306_TAG, "Asynchronous flush already started");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    i2c_ssd1306->async.frame_lock = xSemaphoreCreateMutex();
+    if (i2c_ssd1306->async.frame_lock == NULL)
+    {
+        ESP_LOGE(SSD1306_TAG, "Failed to create the frame lock of the SSD1306 device");
+        return ESP_ERR_NO_MEM;
+    }
+    i2c_ssd1306->async.policy = policy;
+    i2c_ssd1306->async.on_frame_done = on_frame_done;
+    i2c_ssd1306->async.user_ctx = user_ctx;
+    i2c_ssd1306->async.busy = false;
+    i2c_ssd1306->async.pending = false;
+    memcpy(i2c_ssd1306->front, i2c_ssd1306->page, i2c_ssd1306->total_pages * sizeof(ssd1306_page_t));
+    if (xTaskCreate(i2c_ssd1306_async_task, "ssd1306_flush", I2C_SSD1306_ASYNC_STACK_SIZE, i2c_ssd1306, I2C_SSD1306_ASYNC_PRIORITY, &i2c_ssd1306->async.task) != pdPASS)
+    {
+        ESP_LOGE(SSD1306_TAG, "Failed to create the flush task of the SSD1306 device");
+        vSemaphoreDelete(i2c_ssd1306->async.frame_lock);
+        i2c_ssd1306->async.frame_lock = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_ssd1306_frame_begin(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    if (i2c_ssd1306->async.task == NULL)
+        return ESP_OK;
+
+    xSemaphoreTake(i2c_ssd1306->async.frame_lock, portMAX_DELAY);
+
+    return ESP_OK;
+}
+
+/* Wakes the flush task if a coalesced frame is still waiting, for when the task found the frame lock taken. Called after the frame
+   lock is given back, so the task can take it. */
+static void i2c_ssd1306_async_kick_pending(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    bool pending = i2c_ssd1306->async.pending;
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+    if (pending)
+        xTaskNotify(i2c_ssd1306->async.task, SSD1306_NOTIFY_PENDING, eSetBits);
+}
+
+esp_err_t i2c_ssd1306_frame_end(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    if (i2c_ssd1306->async.task == NULL)
+        return ESP_OK;
+
+    xSemaphoreGive(i2c_ssd1306->async.frame_lock);
+    i2c_ssd1306_async_kick_pending(i2c_ssd1306);
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_ssd1306_frame_submit(i2c_ssd1306_handle_t *i2c_ssd1306)
+{
+    if (i2c_ssd1306->async.task == NULL)
+        return i2c_ssd1306_frame_diff_to_ram(i2c_ssd1306, i2c_ssd1306->page);
+
+    bool start = false;
+    portENTER_CRITICAL(&i2c_ssd1306->async.lock);
+    i2c_ssd1306->stats.frames_submitted++;
+    if (!i2c_ssd1306->async.busy)
+    {
+        /* The swap carries any frame still pending as well */
+        i2c_ssd1306->async.busy = true;
+        i2c_ssd1306->async.pending = false;
+        start = true;
+    }
+    else if (i2c_ssd1306->async.policy == SSD1306_FRAME_COALESCE)
+    {
+        i2c_ssd1306->async.pending = true;
+        i2c_ssd1306->stats.frames_coalesced++;
+    }
+    else
+    {
+        i2c_ssd1306->stats.frames_dropped++;
+    }
+    portEXIT_CRITICAL(&i2c_ssd1306->async.lock);
+
+    if (start)
+    {
+        i2c_ssd1306_async_swap(i2c_ssd1306);
+        xTaskNotify(i2c_ssd1306->async.task, SSD1306_NOTIFY_FRAME, eSetBits);
+    }
+    xSemaphoreGive(i2c_ssd1306->async.frame_lock);
+    if (!start)
+        i2c_ssd1306_async_kick_pending(i2c_ssd1306);
+
+    return ESP_OK;
+}
@@ -1,14 +1,28 @@
 #pragma once
 
-#include <driver/i2c_master.h>
 #include <esp_err.h>
 #include <esp_log.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "ssd1306_font.h"
+#include "ssd1306_transport.h"
 
 #define SSD1306_TAG "SSD1306"
 
-#define I2C_SSD1306_TIMEOUT_MS 1000
+#define I2C_SSD1306_ASYNC_STACK_SIZE 3072
+#define I2C_SSD1306_ASYNC_PRIORITY 2
+
+#define SSD1306_MAX_WIDTH 128
+#define SSD1306_MAX_PAGES 8
+
+#define SSD1306_TEXT_MAX_SCALE 3
+#define SSD1306_GLYPH_CACHE_SIZE 16
+
+/*  Largest run of unchanged segments that the diff flush still resends to join two changed runs. Splitting a run costs one extra
+    addressing transaction (control byte + 3 command bytes) plus one extra data transaction header, roughly 7 bytes on the bus. */
+#define SSD1306_DIFF_MERGE_GAP 7
 
 /**
  * @brief Enumeration for SSD1306 display orientation.
@@ -21,16 +35,103 @@ typedef enum
     SSD1306_BOTTOM_TO_TOP
 } ssd1306_wise_t;
 
+/**
+ * @brief Enumeration for SSD1306 GDDRAM addressing mode.
+ *
+ * Page addressing transfers one page per transaction. Horizontal addressing lets a whole frame, or any rectangular window of
+ * pages and segments, be streamed in a single transaction.
+ */
+typedef enum
+{
+    SSD1306_ADDR_MODE_PAGE,
+    SSD1306_ADDR_MODE_HORIZONTAL
+} ssd1306_addr_mode_t;
+
+/**
+ * @brief Enumeration for what happens to a frame submitted while the previous one is still being transferred.
+ *
+ * SSD1306_FRAME_DROP discards the new frame. SSD1306_FRAME_COALESCE transfers the latest submitted content as soon as the bus is
+ * free, folding every frame submitted in between into it.
+ */
+typedef enum
+{
+    SSD1306_FRAME_DROP,
+    SSD1306_FRAME_COALESCE
+} ssd1306_frame_policy_t;
+
+/**
+ * @brief Enumeration for the direction of the SSD1306 continuous horizontal scroll.
+ */
+typedef enum
+{
+    SSD1306_SCROLL_RIGHT,
+    SSD1306_SCROLL_LEFT
+} ssd1306_scroll_dir_t;
+
+/**
+ * @brief Enumeration for the time between scroll steps of the SSD1306, in frames.
+ *
+ * The values are the interval encoding of the scroll setup commands.
+ */
+typedef enum
+{
+    SSD1306_SCROLL_2_FRAMES = 0x07,
+    SSD1306_SCROLL_3_FRAMES = 0x04,
+    SSD1306_SCROLL_4_FRAMES = 0x05,
+    SSD1306_SCROLL_5_FRAMES = 0x00,
+    SSD1306_SCROLL_25_FRAMES = 0x06,
+    SSD1306_SCROLL_64_FRAMES = 0x01,
+    SSD1306_SCROLL_128_FRAMES = 0x02,
+    SSD1306_SCROLL_256_FRAMES = 0x03
+} ssd1306_scroll_interval_t;
+
 /**
  * @brief Structure for an SSD1306 page segment.
  *
- * Contains a pointer to the segment data for a page in the SSD1306 buffer.
+ * Contains the segment data for a page in the SSD1306 buffer, prefixed by the data control byte so the page can be handed to the
+ * I2C driver without copying.
  */
 typedef struct
 {
-    uint8_t *segment;
+    uint8_t control;
+    uint8_t segment[SSD1306_MAX_WIDTH];
 } ssd1306_page_t;
 
+/**
+ * @brief Glyph of an SSD1306 font expanded to a larger scale.
+ *
+ * Holds 'scale' pages of SSD1306_FONT_CELL_SIZE * 'scale' column bytes, ready to be blitted like an unscaled glyph. An entry with
+ * 'scale' 0 is empty. 'last_used' is the cache tick of the latest lookup that returned the entry.
+ */
+typedef struct
+{
+    const ssd1306_font_t *font;
+    uint16_t glyph_index;
+    uint8_t scale;
+    uint32_t last_used;
+    uint8_t page[SSD1306_TEXT_MAX_SCALE][SSD1306_FONT_CELL_SIZE * SSD1306_TEXT_MAX_SCALE];
+} ssd1306_scaled_glyph_t;
+
+/**
+ * @brief I2C traffic counters for the SSD1306 display.
+ *
+ * Accumulates the bytes written to the bus (commands, control bytes and data), the GDDRAM bytes that were not resent because the
+ * display already held them, the latency of the buffer flushes, and what happened to the frames submitted asynchronously.
+ */
+typedef struct
+{
+    uint32_t bytes_sent;
+    uint32_t bytes_skipped;
+    uint32_t transactions;
+    uint32_t flushes;
+    uint32_t last_flush_us;
+    uint32_t max_flush_us;
+    uint64_t total_flush_us;
+    uint32_t frames_submitted;
+    uint32_t frames_dropped;
+    uint32_t frames_coalesced;
+} ssd1306_flush_stats_t;
+
 /**
  * @brief Configuration for the I2C SSD1306 display.
  *
@@ -43,29 +144,86 @@ typedef struct
     uint8_t width;
     uint8_t height;
     ssd1306_wise_t wise;
+    ssd1306_addr_mode_t addr_mode;
 } i2c_ssd1306_config_t;
 
+typedef struct i2c_ssd1306_handle i2c_ssd1306_handle_t;
+
 /**
- * @brief Handle for the I2C SSD1306 display.
+ * @brief Callback invoked from the flush task when an asynchronous frame transfer completes.
  *
- * Contains runtime information including the I2C device handle, display dimensions, and pointers to the page buffers.
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param result      ESP_OK if the frame reached the display, or the transfer error otherwise.
+ * @param user_ctx    User context given to i2c_ssd1306_async_start().
+ */
+typedef void (*ssd1306_frame_done_cb_t)(i2c_ssd1306_handle_t *i2c_ssd1306, esp_err_t result, void *user_ctx);
+
+/**
+ * @brief State of the asynchronous flush of the SSD1306 display.
+ *
+ * The flush task owns the front buffer while 'busy' is set. The frame lock is held by whoever is writing the back buffer, either the
+ * application between i2c_ssd1306_frame_begin() and i2c_ssd1306_frame_submit() or the flush task while it swaps a pending frame in.
+ * 'pending' marks a coalesced frame that has not been swapped in yet; it is kept until the flush task gets the frame lock.
  */
 typedef struct
 {
-    i2c_master_dev_handle_t i2c_master_dev;
+    TaskHandle_t task;
+    SemaphoreHandle_t frame_lock;
+    portMUX_TYPE lock;
+    bool busy;
+    bool pending;
+    ssd1306_frame_policy_t policy;
+    ssd1306_frame_done_cb_t on_frame_done;
+    void *user_ctx;
+} ssd1306_async_t;
+
+/**
+ * @brief Handle for the I2C SSD1306 display.
+ *
+ * Contains runtime information including the transport to the display, display dimensions, the font used for text and a least
+ * recently used cache of its scaled glyphs with a count of the expansions it missed, the statically sized back and front page
+ * buffers, and a shadow copy of the display GDDRAM. The shadow is only marked valid by a full flush if 'gram_generation', bumped
+ * by every invalidation, did not change during the transfer. No frame is transferred while 'scroll_active' is set.
+ */
+struct i2c_ssd1306_handle
+{
+    ssd1306_transport_t transport;
     uint8_t width;
     uint8_t height;
     uint8_t total_pages;
+    ssd1306_addr_mode_t addr_mode;
+    const ssd1306_font_t *font;
+    ssd1306_scaled_glyph_t glyph_cache[SSD1306_GLYPH_CACHE_SIZE];
+    uint32_t glyph_cache_tick;
+    uint32_t glyph_cache_misses;
+    ssd1306_page_t frame[2][SSD1306_MAX_PAGES];
     ssd1306_page_t *page;
-} i2c_ssd1306_handle_t;
+    ssd1306_page_t *front;
+    uint8_t gram[SSD1306_MAX_PAGES][SSD1306_MAX_WIDTH];
+    bool gram_valid;
+    uint32_t gram_generation;
+    bool scroll_active;
+    ssd1306_flush_stats_t stats;
+    ssd1306_async_t async;
+};
 
 
+#ifdef ESP_PLATFORM
 void init_ssd1306(void);
+esp_err_t ssd1306_begin_frame(void);
+esp_err_t ssd1306_end_frame(void);
+esp_err_t ssd1306_fill_area(uint8_t x1, uint8_t x2, uint8_t y1, uint8_t y2, bool fill);
 esp_err_t ssd1306_print_str(uint8_t x, uint8_t y, const char *text, bool invert);
+esp_err_t ssd1306_print_str_scaled(uint8_t x, uint8_t y, const char *text, uint8_t scale, bool invert);
+esp_err_t ssd1306_print_str_clipped(uint8_t x, uint8_t y, const char *text, uint8_t scale, uint8_t width, bool invert);
 esp_err_t ssd1306_display(void);
 esp_err_t ssd1306_clear(void);
+esp_err_t ssd1306_invalidate(void);
+esp_err_t ssd1306_get_flush_stats(ssd1306_flush_stats_t *stats);
+#endif
 
 
+#ifdef ESP_PLATFORM
 /**
  * @brief Initialize the I2C SSD1306 display.
  *
@@ -78,15 +236,32 @@ esp_err_t ssd1306_clear(void);
  * @return
  *   - ESP_OK on success.
  *   - ESP_ERR_INVALID_ARG if an argument is invalid.
- *   - ESP_ERR_NO_MEM if memory allocation fails.
  *   - ESP_FAIL on other failures.
  */
 esp_err_t i2c_ssd1306_init(i2c_master_bus_handle_t i2c_master_bus, i2c_ssd1306_config_t i2c_ssd1306_config, i2c_ssd1306_handle_t *i2c_ssd1306);
+#endif
+
+/**
+ * @brief Initialize the SSD1306 display over an existing transport.
+ *
+ * Sends the initialization sequence through the given transport and takes ownership of it, so it is released by
+ * i2c_ssd1306_deinit(). The I2C fields of the configuration are ignored.
+ *
+ * @param transport            Transport created by ssd1306_i2c_transport_init() or ssd1306_ram_transport_init().
+ * @param i2c_ssd1306_config   Configuration parameters for the SSD1306 display.
+ * @param i2c_ssd1306          Pointer to the SSD1306 handle to be initialized.
+ *
+ * @return
+ *   - ESP_OK on success.
+ *   - ESP_ERR_INVALID_ARG if an argument is invalid.
+ *   - ESP_FAIL on other failures.
+ */
+esp_err_t i2c_ssd1306_init_transport(ssd1306_transport_t transport, i2c_ssd1306_config_t i2c_ssd1306_config, i2c_ssd1306_handle_t *i2c_ssd1306);
 
 /**
  * @brief Deinitialize the I2C SSD1306 display.
  *
- * Frees the memory allocated for the SSD1306 display handle.
+ * Releases the transport of the SSD1306 display, removing it from the I2C bus when it is the I2C transport.
  *
  * @param i2c_ssd1306 Pointer to the SSD1306 handle.
  *
@@ -158,25 +333,84 @@ esp_err_t i2c_ssd1306_buffer_fill_pixel(i2c_ssd1306_handle_t *i2c_ssd1306, uint8
  */
 esp_err_t i2c_ssd1306_buffer_fill_space(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x1, uint8_t x2, uint8_t y1, uint8_t y2, bool fill);
 
+/**
+ * @brief Select the font used to render text into the SSD1306 buffer.
+ *
+ * The display starts with ssd1306_font8x8, generated at build time from main/fonts/font8x8.bdf.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param font        Font generated by tools/bdf2font.py.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_set_font(i2c_ssd1306_handle_t *i2c_ssd1306, const ssd1306_font_t *font);
+
+/**
+ * @brief Measure the width of a string in the current SSD1306 font.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param text        Null-terminated UTF-8 string to measure.
+ *
+ * @return Width of the string in columns, to be multiplied by the scale for text drawn with i2c_ssd1306_buffer_text_scaled().
+ */
+uint16_t i2c_ssd1306_text_width(i2c_ssd1306_handle_t *i2c_ssd1306, const char *text);
+
 /**
  * @brief Render text into the SSD1306 buffer.
  *
- * Copies 8x8 font characters representing the provided string into the SSD1306 buffer.
+ * Copies the glyphs of the current font representing the provided UTF-8 string into the SSD1306 buffer. Code points missing from
+ * the font are drawn with its fallback glyph.
  *
  * @param i2c_ssd1306 Pointer to the SSD1306 handle.
  * @param x           X-coordinate for the text's starting position.
  * @param y           Y-coordinate for the text's starting position.
- * @param text        Null-terminated string to render.
+ * @param text        Null-terminated UTF-8 string to render.
  * @param invert      If true, the text is rendered inverted.
  *
  * @return ESP_OK on success, or an error code otherwise.
  */
 esp_err_t i2c_ssd1306_buffer_text(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, bool invert);
 
+/**
+ * @brief Render scaled text into the SSD1306 buffer.
+ *
+ * Draws the glyphs of the current font enlarged 'scale' times in both directions, so a glyph covers 'scale' pages and its advance
+ * is multiplied by 'scale'. Scaled glyphs are expanded with bit-spreading tables the first time they are drawn and kept in a small
+ * cache, after which they are blitted like unscaled text.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param x           X-coordinate for the text's starting position.
+ * @param y           Y-coordinate for the text's starting position.
+ * @param text        Null-terminated UTF-8 string to render.
+ * @param scale       Scale factor, between 1 and SSD1306_TEXT_MAX_SCALE.
+ * @param invert      If true, the text is rendered inverted.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_buffer_text_scaled(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, uint8_t scale, bool invert);
+
+/**
+ * @brief Render scaled text into the SSD1306 buffer, clipped to a column range.
+ *
+ * Same as i2c_ssd1306_buffer_text_scaled(), but glyph columns from 'x' + 'width' on are not drawn, so text wider than its region
+ * never reaches the columns to its right.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param x           X-coordinate for the text's starting position.
+ * @param y           Y-coordinate for the text's starting position.
+ * @param text        Null-terminated UTF-8 string to render.
+ * @param scale       Scale factor, between 1 and SSD1306_TEXT_MAX_SCALE.
+ * @param width       Columns available to the text, at least 1. Columns past the display edge are clipped too.
+ * @param invert      If true, the text is rendered inverted.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_buffer_text_clipped(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const char *text, uint8_t scale, uint8_t width, bool invert);
+
 /**
  * @brief Render an integer into the SSD1306 buffer.
  *
- * Copies 8x8 font characters representing the given integer into the SSD1306 buffer.
+ * Copies the font glyphs representing the given integer into the SSD1306 buffer.
  *
  * @param i2c_ssd1306 Pointer to the SSD1306 handle.
  * @param x           X-coordinate for the integer's starting position.
@@ -191,16 +425,17 @@ esp_err_t i2c_ssd1306_buffer_int(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, u
 /**
  * @brief Render a floating-point number into the SSD1306 buffer.
  *
- * Copies 8x8 font characters representing the given float value into the SSD1306 buffer.
+ * Copies the font glyphs representing the given float value into the SSD1306 buffer. The value is rounded to a fixed-point
+ * integer and formatted without the float printf code.
  *
  * @param i2c_ssd1306 Pointer to the SSD1306 handle.
  * @param x           X-coordinate for the float's starting position.
  * @param y           Y-coordinate for the float's starting position.
  * @param value       Float value to render.
- * @param decimals    Number of decimal places to display.
+ * @param decimals    Number of decimal places to display, at most 6.
  * @param invert      If true, the float is rendered inverted.
  *
- * @return ESP_OK on success, or an error code otherwise.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the decimals or the scaled value are out of range, or an error code otherwise.
  */
 esp_err_t i2c_ssd1306_buffer_float(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, float value, uint8_t decimals, bool invert);
 
@@ -221,6 +456,18 @@ esp_err_t i2c_ssd1306_buffer_float(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x,
  */
 esp_err_t i2c_ssd1306_buffer_image(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t x, uint8_t y, const uint8_t *image, uint8_t width, uint8_t height, bool invert);
 
+/**
+ * @brief Change the GDDRAM addressing mode of the SSD1306 display.
+ *
+ * Switches between page and horizontal addressing at runtime, so both transfer paths can be compared on the same panel.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param addr_mode   Addressing mode to use for subsequent transfers.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_set_addr_mode(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_addr_mode_t addr_mode);
+
 /**
  * @brief Transfer a specific buffer segment to the SSD1306 display RAM.
  *
@@ -260,6 +507,22 @@ esp_err_t i2c_ssd1306_segments_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t
  */
 esp_err_t i2c_ssd1306_page_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t page);
 
+/**
+ * @brief Transfer a rectangular window of the buffer to the SSD1306 display RAM.
+ *
+ * In horizontal addressing mode the window is streamed in a single transaction. In page addressing mode every page of the window
+ * is transferred separately.
+ *
+ * @param i2c_ssd1306     Pointer to the SSD1306 handle.
+ * @param initial_page    Starting page number.
+ * @param final_page      Ending page number.
+ * @param initial_segment Starting segment number.
+ * @param final_segment   Ending segment number.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_window_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t initial_page, uint8_t final_page, uint8_t initial_segment, uint8_t final_segment);
+
 /**
  * @brief Transfer a range of pages from the buffer to the SSD1306 display RAM.
  *
@@ -282,4 +545,158 @@ esp_err_t i2c_ssd1306_pages_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t in
  *
  * @return ESP_OK on success, or an error code otherwise.
  */
-esp_err_t i2c_ssd1306_buffer_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306);
\ No newline at end of file
+esp_err_t i2c_ssd1306_buffer_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306);
+
+/**
+ * @brief Transfer only the changed parts of the buffer to the SSD1306 display RAM.
+ *
+ * Compares every page of the buffer against the shadow copy of the display GDDRAM and transfers the runs of segments that differ,
+ * merging runs separated by no more than SSD1306_DIFF_MERGE_GAP unchanged segments. The whole buffer is transferred when the
+ * shadow copy is not valid yet.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_buffer_diff_to_ram(i2c_ssd1306_handle_t *i2c_ssd1306);
+
+/**
+ * @brief Start a continuous horizontal scroll of the SSD1306 display.
+ *
+ * The controller moves the given pages by one column every 'interval' frames on its own, with no further bus traffic. Frames are not
+ * transferred while scrolling: synchronous transfers fail with ESP_ERR_INVALID_STATE and asynchronous frames wait until
+ * i2c_ssd1306_scroll_stop(). Waits for an asynchronous frame transfer in progress to finish before sending the commands, so it must
+ * not be called between i2c_ssd1306_frame_begin() and the end of the frame.
+ *
+ * @param i2c_ssd1306  Pointer to the SSD1306 handle.
+ * @param direction    Scroll direction.
+ * @param initial_page First page that scrolls.
+ * @param final_page   Last page that scrolls.
+ * @param interval     Time between scroll steps.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_scroll_horizontal(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_scroll_dir_t direction, uint8_t initial_page, uint8_t final_page, ssd1306_scroll_interval_t interval);
+
+/**
+ * @brief Start a continuous diagonal scroll of the SSD1306 display.
+ *
+ * Like i2c_ssd1306_scroll_horizontal(), and on every step the whole display also moves up by 'vertical_offset' rows.
+ *
+ * @param i2c_ssd1306     Pointer to the SSD1306 handle.
+ * @param direction       Horizontal scroll direction.
+ * @param initial_page    First page that scrolls horizontally.
+ * @param final_page      Last page that scrolls horizontally.
+ * @param interval        Time between scroll steps.
+ * @param vertical_offset Rows moved up on every step, between 1 and the display height minus 1.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_scroll_diagonal(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_scroll_dir_t direction, uint8_t initial_page, uint8_t final_page, ssd1306_scroll_interval_t interval, uint8_t vertical_offset);
+
+/**
+ * @brief Stop scrolling the SSD1306 display.
+ *
+ * Scrolling rewrites the display GDDRAM, so the shadow copy is invalidated and the next diff flush transfers the whole buffer. An
+ * asynchronous frame deferred while scrolling is sent right away.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_scroll_stop(i2c_ssd1306_handle_t *i2c_ssd1306);
+
+/**
+ * @brief Set the display start line of the SSD1306.
+ *
+ * Shifts the whole picture up by 'line' rows, wrapping around, without transferring any GDDRAM data. Successive calls give a cheap
+ * vertical scroll. Waits for an asynchronous frame transfer in progress to finish before sending the command.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param line        GDDRAM row shown at the top of the display, between 0 and 63.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_set_start_line(i2c_ssd1306_handle_t *i2c_ssd1306, uint8_t line);
+
+/**
+ * @brief Invalidate the shadow copy of the SSD1306 display GDDRAM.
+ *
+ * The next diff flush, synchronous or asynchronous, transfers the whole buffer. Used to resynchronize the display after it may have
+ * lost its contents, or as a periodic keep-alive.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_invalidate(i2c_ssd1306_handle_t *i2c_ssd1306);
+
+/**
+ * @brief Get the I2C traffic counters of the SSD1306 display.
+ *
+ * Copies the bytes sent and skipped and the flush latencies since the display was initialized.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ * @param stats       Pointer where the counters are copied.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_get_flush_stats(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_flush_stats_t *stats);
+
+/**
+ * @brief Start the asynchronous, double-buffered flush of the SSD1306 display.
+ *
+ * Creates a flush task that transfers the front buffer while the application keeps drawing into the back buffer. Once started,
+ * frames must be drawn between i2c_ssd1306_frame_begin() and i2c_ssd1306_frame_submit(), and the synchronous *_to_ram functions
+ * must no longer be used.
+ *
+ * @param i2c_ssd1306   Pointer to the SSD1306 handle.
+ * @param policy        What to do with frames submitted while a transfer is in progress.
+ * @param on_frame_done Callback invoked from the flush task after every transfer, or NULL.
+ * @param user_ctx      User context passed to the callback.
+ *
+ * @return
+ *   - ESP_OK on success.
+ *   - ESP_ERR_INVALID_ARG if the policy is invalid.
+ *   - ESP_ERR_INVALID_STATE if the asynchronous flush is already started.
+ *   - ESP_ERR_NO_MEM if the flush task or its lock cannot be created.
+ */
+esp_err_t i2c_ssd1306_async_start(i2c_ssd1306_handle_t *i2c_ssd1306, ssd1306_frame_policy_t policy, ssd1306_frame_done_cb_t on_frame_done, void *user_ctx);
+
+/**
+ * @brief Begin drawing a frame into the SSD1306 back buffer.
+ *
+ * Waits while the flush task swaps a pending frame in, which only takes a buffer copy. Does nothing if the asynchronous flush is
+ * not started.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_frame_begin(i2c_ssd1306_handle_t *i2c_ssd1306);
+
+/**
+ * @brief Finish drawing into the SSD1306 back buffer without submitting a frame.
+ *
+ * The drawing is kept in the back buffer and goes out with the next submitted frame. If a coalesced frame is still waiting because
+ * the flush task found the back buffer in use, the flush task is woken to send it. Does nothing if the asynchronous flush is not
+ * started.
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_frame_end(i2c_ssd1306_handle_t *i2c_ssd1306);
+
+/**
+ * @brief Submit the frame drawn into the SSD1306 back buffer.
+ *
+ * If the bus is idle the buffers are swapped and the flush task starts transferring the frame; otherwise the frame is dropped or
+ * coalesced according to the policy. Never waits for the bus. Without the asynchronous flush, the frame is transferred with
+ * i2c_ssd1306_buffer_diff_to_ram().
+ *
+ * @param i2c_ssd1306 Pointer to the SSD1306 handle.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t i2c_ssd1306_frame_submit(i2c_ssd1306_handle_t *i2c_ssd1306);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SSD1306_FONT_CELL_SIZE 8
+
+/**
+ * @brief Range of consecutive code points present in an SSD1306 font.
+ *
+ * The glyph of code point 'first' is stored at 'glyph_index' in the font glyph table, followed by the rest of the range in order.
+ */
+typedef struct
+{
+    uint16_t first;
+    uint16_t last;
+    uint16_t glyph_index;
+} ssd1306_font_range_t;
+
+/**
+ * @brief Sparse, range-indexed bitmap font for the SSD1306 display.
+ *
+ * Generated from a BDF source by tools/bdf2font.py. Every glyph is SSD1306_FONT_CELL_SIZE column bytes with bit 0 at the top row,
+ * left aligned in its cell. 'advance' holds the per-glyph width in columns for proportional fonts, or is NULL when every glyph
+ * advances by 'width'. Code points outside every range are drawn with the 'fallback' glyph.
+ */
+typedef struct
+{
+    const ssd1306_font_range_t *ranges;
+    uint8_t total_ranges;
+    const uint8_t (*glyphs)[SSD1306_FONT_CELL_SIZE];
+    const uint8_t *advance;
+    uint8_t width;
+    uint16_t fallback;
+} ssd1306_font_t;
+
+extern const ssd1306_font_t ssd1306_font8x8;
@@ -0,0 +1,234 @@
+#include "ssd1306_transport.h"
+#include <esp_log.h>
+#include <string.h>
+#include "ssd1306_const.h"
+
+static const char *TAG = "SSD1306_TRANSPORT";
+
+#define SSD1306_RAM_ADDR_MODE_HORIZONTAL 0x00
+#define SSD1306_RAM_ADDR_MODE_VERTICAL 0x01
+#define SSD1306_RAM_ADDR_MODE_PAGE 0x02
+
+/* Longest command understood by the controller, the continuous scroll setup with its six parameter bytes. */
+#define SSD1306_RAM_MAX_COMMAND_SIZE 7
+
+esp_err_t ssd1306_transport_transmit(ssd1306_transport_t *transport, const ssd1306_transport_buffer_t *buffers, size_t total_buffers)
+{
+    if (total_buffers == 0 || total_buffers > SSD1306_TRANSPORT_MAX_BUFFERS)
+    {
+        ESP_LOGE(TAG, "Invalid transaction, it must have between 1 and %d buffers", SSD1306_TRANSPORT_MAX_BUFFERS);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return transport->transmit(transport, buffers, total_buffers);
+}
+
+esp_err_t ssd1306_transport_deinit(ssd1306_transport_t *transport)
+{
+    if (transport->deinit == NULL)
+        return ESP_OK;
+
+    return transport->deinit(transport);
+}
+
+/* Number of parameter bytes that follow each multi-byte command of the controller. */
+static uint8_t ssd1306_ram_command_params(uint8_t command)
+{
+    switch (command)
+    {
+    case OLED_CMD_SET_MEMORY_ADDR_MODE:
+    case OLED_CMD_SET_CONTRAST_CONTROL:
+    case OLED_CMD_SET_CHARGE_PUMP:
+    case OLED_CMD_SET_MUX_RATIO:
+    case OLED_CMD_SET_VERT_DISPLAY_OFFSET:
+    case OLED_CMD_SET_DISPLAY_CLK_DIVIDE:
+    case OLED_CMD_SET_PRECHARGE_PERIOD:
+    case OLED_CMD_SET_COM_PIN_HARDWARE_MAP:
+    case OLED_CMD_SET_VCOMH_DESELECT_LEVEL:
+        return 1;
+    case OLED_CMD_SET_COLUMN_ADDR_RANGE:
+    case OLED_CMD_SET_PAGE_ADDR_RANGE:
+    case OLED_CMD_SET_VERTICAL_SCROLL_AREA:
+        return 2;
+    case OLED_CMD_VERTICAL_RIGHT_HORIZONTAL_SCROLL:
+    case OLED_CMD_VERTICAL_LEFT_HORIZONTAL_SCROLL:
+        return 5;
+    case OLED_CMD_RIGHT_HORIZONTAL_SCROLL:
+    case OLED_CMD_LEFT_HORIZONTAL_SCROLL:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void ssd1306_ram_command(ssd1306_ram_t *ram, const uint8_t *command)
+{
+    switch (command[0])
+    {
+    case OLED_CMD_SET_MEMORY_ADDR_MODE:
+        ram->addr_mode = command[1] & 0x03;
+        return;
+    case OLED_CMD_SET_COLUMN_ADDR_RANGE:
+        ram->initial_column = command[1] & 0x7F;
+        ram->final_column = command[2] & 0x7F;
+        ram->column = ram->initial_column;
+        return;
+    case OLED_CMD_SET_PAGE_ADDR_RANGE:
+        ram->initial_page = command[1] & 0x07;
+        ram->final_page = command[2] & 0x07;
+        ram->page = ram->initial_page;
+        return;
+    case OLED_CMD_DISPLAY_OFF:
+        ram->display_on = false;
+        return;
+    case OLED_CMD_DISPLAY_ON:
+        ram->display_on = true;
+        return;
+    case OLED_CMD_ACTIVATE_SCROLL:
+        ram->scrolling = true;
+        return;
+    case OLED_CMD_DEACTIVATE_SCROLL:
+        ram->scrolling = false;
+        return;
+    }
+
+    if ((command[0] & 0xC0) == OLED_MASK_DISPLAY_START_LINE)
+        ram->start_line = command[0] & 0x3F;
+    else if ((command[0] & 0xF8) == OLED_MASK_PAGE_ADDR)
+        ram->page = command[0] & 0x07;
+    else if ((command[0] & 0xF0) == OLED_MASK_LSB_NIBBLE_SEG_ADDR)
+        ram->column = (ram->column & 0xF0) | (command[0] & 0x0F);
+    else if ((command[0] & 0xF0) == OLED_MASK_HSB_NIBBLE_SEG_ADDR)
+        ram->column = (command[0] & 0x07) << 4 | (ram->column & 0x0F);
+}
+
+/* Stores a data byte and advances the pointers like the controller does in the current addressing mode. */
+static void ssd1306_ram_data(ssd1306_ram_t *ram, uint8_t data)
+{
+    ram->gram[ram->page][ram->column] = data;
+
+    switch (ram->addr_mode)
+    {
+    case SSD1306_RAM_ADDR_MODE_HORIZONTAL:
+        if (ram->column != ram->final_column)
+        {
+            ram->column++;
+            break;
+        }
+        ram->column = ram->initial_column;
+        ram->page = ram->page == ram->final_page ? ram->initial_page : ram->page + 1;
+        break;
+    case SSD1306_RAM_ADDR_MODE_VERTICAL:
+        if (ram->page != ram->final_page)
+        {
+            ram->page++;
+            break;
+        }
+        ram->page = ram->initial_page;
+        ram->column = ram->column == ram->final_column ? ram->initial_column : ram->column + 1;
+        break;
+    default:
+        ram->column = (ram->column + 1) % SSD1306_RAM_MAX_WIDTH;
+        break;
+    }
+}
+
+static esp_err_t ssd1306_ram_transmit(ssd1306_transport_t *transport, const ssd1306_transport_buffer_t *buffers, size_t total_buffers)
+{
+    ssd1306_ram_t *ram = (ssd1306_ram_t *)transport->ctx;
+    if (buffers[0].size == 0)
+    {
+        ESP_LOGE(TAG, "Invalid transaction, it must start with a control byte");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool data = buffers[0].data[0] & OLED_CONTROL_BYTE_DATA;
+    uint8_t command[SSD1306_RAM_MAX_COMMAND_SIZE];
+    uint8_t command_size = 0;
+    uint8_t command_params = 0;
+    size_t offset = 1;
+    for (size_t i = 0; i < total_buffers; i++)
+    {
+        for (size_t j = offset; j < buffers[i].size; j++)
+        {
+            uint8_t byte = buffers[i].data[j];
+            if (data)
+            {
+                ssd1306_ram_data(ram, byte);
+                continue;
+            }
+
+            if (command_size == 0)
+                command_params = ssd1306_ram_command_params(byte);
+            command[command_size++] = byte;
+            if (command_size > command_params)
+            {
+                ssd1306_ram_command(ram, command);
+                command_size = 0;
+            }
+        }
+        ram->bytes_received += buffers[i].size;
+        offset = 0;
+    }
+    ram->transactions++;
+    if (command_size != 0)
+    {
+        ESP_LOGE(TAG, "Truncated command 0x%02X, %d of %d parameters received", command[0], command_size - 1, command_params);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_ram_transport_init(ssd1306_ram_t *ram, uint8_t width, uint8_t height, ssd1306_transport_t *transport)
+{
+    if (width == 0 || width > SSD1306_RAM_MAX_WIDTH || height % 8 != 0 || height < 16 || height > 64)
+    {
+        ESP_LOGE(TAG, "Invalid in-memory SSD1306, 'width' must be between 1 and %d, 'height' must be between 16 and 64 and multiple of 8", SSD1306_RAM_MAX_WIDTH);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Power-on reset state of the controller. */
+    memset(ram, 0, sizeof(*ram));
+    ram->width = width;
+    ram->height = height;
+    ram->addr_mode = SSD1306_RAM_ADDR_MODE_PAGE;
+    ram->final_page = SSD1306_RAM_MAX_PAGES - 1;
+    ram->final_column = SSD1306_RAM_MAX_WIDTH - 1;
+
+    transport->transmit = ssd1306_ram_transmit;
+    transport->deinit = NULL;
+    transport->ctx = ram;
+
+    return ESP_OK;
+}
+
+bool ssd1306_ram_get_pixel(const ssd1306_ram_t *ram, uint8_t x, uint8_t y)
+{
+    if (x >= ram->width || y >= ram->height)
+        return false;
+
+    return ram->gram[y / 8][x] >> (y % 8) & 1;
+}
+
+esp_err_t ssd1306_ram_write_pbm(const ssd1306_ram_t *ram, FILE *out)
+{
+    if (fprintf(out, "P4\n%d %d\n", ram->width, ram->height) < 0)
+        return ESP_FAIL;
+
+    uint8_t row[SSD1306_RAM_MAX_WIDTH / 8];
+    size_t row_size = (ram->width + 7) / 8;
+    for (uint8_t y = 0; y < ram->height; y++)
+    {
+        memset(row, 0, sizeof(row));
+        for (uint8_t x = 0; x < ram->width; x++)
+        {
+            if (ssd1306_ram_get_pixel(ram, x, y))
+                row[x / 8] |= 0x80 >> (x % 8);
+        }
+        if (fwrite(row, 1, row_size, out) != row_size)
+            return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <esp_err.h>
+
+#define I2C_SSD1306_TIMEOUT_MS 1000
+
+/* A transaction is at most one control byte followed by one slice per display page. */
+#define SSD1306_TRANSPORT_MAX_BUFFERS 9
+
+#define SSD1306_RAM_MAX_WIDTH 128
+#define SSD1306_RAM_MAX_PAGES 8
+
+/**
+ * @brief Buffer of a transaction sent to the SSD1306 display.
+ */
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+} ssd1306_transport_buffer_t;
+
+typedef struct ssd1306_transport ssd1306_transport_t;
+
+/**
+ * @brief Transport that carries the SSD1306 command and data stream.
+ *
+ * The rendering core builds every transaction as a control byte followed by commands or GDDRAM data, split in up to
+ * SSD1306_TRANSPORT_MAX_BUFFERS buffers that must be sent back to back as a single transaction. The transport decides where the
+ * bytes go: the I2C bus for the device, or an in-memory copy of the controller for host builds and frame captures.
+ */
+struct ssd1306_transport
+{
+    esp_err_t (*transmit)(ssd1306_transport_t *transport, const ssd1306_transport_buffer_t *buffers, size_t total_buffers);
+    esp_err_t (*deinit)(ssd1306_transport_t *transport);
+    void *ctx;
+};
+
+/**
+ * @brief In-memory SSD1306 controller.
+ *
+ * Interprets the command stream the way the controller does (addressing mode, page and column pointers, column and page windows)
+ * and stores the data stream in its own GDDRAM. The display start line and whether scrolling is active are tracked but not applied
+ * to the GDDRAM, so the result of a flush can be inspected or dumped without a display.
+ */
+typedef struct
+{
+    uint8_t width;
+    uint8_t height;
+    uint8_t addr_mode;
+    uint8_t page;
+    uint8_t column;
+    uint8_t initial_page;
+    uint8_t final_page;
+    uint8_t initial_column;
+    uint8_t final_column;
+    uint8_t start_line;
+    bool display_on;
+    bool scrolling;
+    uint32_t bytes_received;
+    uint32_t transactions;
+    uint8_t gram[SSD1306_RAM_MAX_PAGES][SSD1306_RAM_MAX_WIDTH];
+} ssd1306_ram_t;
+
+/**
+ * @brief Send a transaction through an SSD1306 transport.
+ *
+ * @param transport     Pointer to the transport.
+ * @param buffers       Buffers of the transaction, in order.
+ * @param total_buffers Number of buffers, at most SSD1306_TRANSPORT_MAX_BUFFERS.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t ssd1306_transport_transmit(ssd1306_transport_t *transport, const ssd1306_transport_buffer_t *buffers, size_t total_buffers);
+
+/**
+ * @brief Release the resources of an SSD1306 transport.
+ *
+ * @param transport Pointer to the transport.
+ *
+ * @return ESP_OK on success, or an error code otherwise.
+ */
+esp_err_t ssd1306_transport_deinit(ssd1306_transport_t *transport);
+
+#ifdef ESP_PLATFORM
+#include <driver/i2c_master.h>
+
+/**
+ * @brief Create an I2C transport for the SSD1306 display.
+ *
+ * Probes the device and adds it to the I2C bus.
+ *
+ * @param i2c_master_bus     An initialized I2C master bus handle.
+ * @param i2c_device_address 7-bit address of the display.
+ * @param i2c_scl_speed_hz   SCL frequency, at most 400000.
+ * @param transport          Pointer to the transport to be initialized.
+ *
+ * @return
+ *   - ESP_OK on success.
+ *   - ESP_ERR_INVALID_ARG if the SCL frequency is invalid.
+ *   - ESP_ERR_NOT_FOUND or ESP_ERR_TIMEOUT if the device does not answer.
+ *   - ESP_FAIL on other failures.
+ */
+esp_err_t ssd1306_i2c_transport_init(i2c_master_bus_handle_t i2c_master_bus, uint16_t i2c_device_address, uint32_t i2c_scl_speed_hz, ssd1306_transport_t *transport);
+#endif
+
+/**
+ * @brief Create an in-memory transport for the SSD1306 display.
+ *
+ * Every transaction is applied to the given in-memory controller instead of a device.
+ *
+ * @param ram       In-memory controller, owned by the caller and valid while the transport is in use.
+ * @param width     Width of the emulated panel in pixels, at most SSD1306_RAM_MAX_WIDTH.
+ * @param height    Height of the emulated panel in pixels, a multiple of 8 up to 64.
+ * @param transport Pointer to the transport to be initialized.
+ *
+ * @return ESP_OK on success, or ESP_ERR_INVALID_ARG if the panel size is invalid.
+ */
+esp_err_t ssd1306_ram_transport_init(ssd1306_ram_t *ram, uint8_t width, uint8_t height, ssd1306_transport_t *transport);
+
+/**
+ * @brief Read a pixel of the in-memory controller GDDRAM.
+ *
+ * @param ram Pointer to the in-memory controller.
+ * @param x   X-coordinate of the pixel.
+ * @param y   Y-coordinate of the pixel.
+ *
+ * @return true if the pixel is set, false if it is clear or out of the panel.
+ */
+bool ssd1306_ram_get_pixel(const ssd1306_ram_t *ram, uint8_t x, uint8_t y);
+
+/**
+ * @brief Write the in-memory controller GDDRAM as a binary PBM (P4) image.
+ *
+ * The image is in GDDRAM coordinates, which are the coordinates used to draw into the SSD1306 buffer.
+ *
+ * @param ram Pointer to the in-memory controller.
+ * @param out Stream the image is written to.
+ *
+ * @return ESP_OK on success, or ESP_FAIL if the stream could not be written.
+ */
+esp_err_t ssd1306_ram_write_pbm(const ssd1306_ram_t *ram, FILE *out);
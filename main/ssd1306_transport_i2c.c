@@ -0,0 +1,79 @@
+#include "ssd1306_transport.h"
+#include <esp_log.h>
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "SSD1306_I2C";
+
+static esp_err_t ssd1306_i2c_transmit(ssd1306_transport_t *transport, const ssd1306_transport_buffer_t *buffers, size_t total_buffers)
+{
+    i2c_master_dev_handle_t i2c_master_dev = (i2c_master_dev_handle_t)transport->ctx;
+    if (total_buffers == 1)
+        return i2c_master_transmit(i2c_master_dev, buffers[0].data, buffers[0].size, I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+
+    i2c_master_transmit_multi_buffer_info_t i2c_buffers[SSD1306_TRANSPORT_MAX_BUFFERS];
+    for (size_t i = 0; i < total_buffers; i++)
+    {
+        i2c_buffers[i] = (i2c_master_transmit_multi_buffer_info_t){.write_buffer = (uint8_t *)buffers[i].data, .buffer_size = buffers[i].size};
+    }
+
+    return i2c_master_multi_buffer_transmit(i2c_master_dev, i2c_buffers, total_buffers, I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+}
+
+static esp_err_t ssd1306_i2c_deinit(ssd1306_transport_t *transport)
+{
+    esp_err_t ret = i2c_master_bus_rm_device((i2c_master_dev_handle_t)transport->ctx);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to remove I2C SSD1306 device");
+        return ret;
+    }
+    transport->ctx = NULL;
+
+    return ret;
+}
+
+esp_err_t ssd1306_i2c_transport_init(i2c_master_bus_handle_t i2c_master_bus, uint16_t i2c_device_address, uint32_t i2c_scl_speed_hz, ssd1306_transport_t *transport)
+{
+    if (i2c_scl_speed_hz > 400000)
+    {
+        ESP_LOGE(TAG, "Invalid I2C SSD1306 configuration, 'i2c_scl_speed_hz' must be less than or equal to 400000");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = i2c_master_probe(i2c_master_bus, i2c_device_address, I2C_SSD1306_TIMEOUT_MS / portTICK_PERIOD_MS);
+    if (ret != ESP_OK)
+    {
+        switch (ret)
+        {
+        case ESP_ERR_NOT_FOUND:
+            ESP_LOGE(TAG, "I2C SSD1306 device not found in address 0x%02X", i2c_device_address);
+            break;
+        case ESP_ERR_TIMEOUT:
+            ESP_LOGE(TAG, "I2C SSD1306 device timeout in address 0x%02X", i2c_device_address);
+            break;
+        default:
+            ESP_LOGE(TAG, "I2C SSD1306 device error in address 0x%02X", i2c_device_address);
+            break;
+        }
+
+        return ret;
+    }
+
+    i2c_device_config_t i2c_device_config = {
+        .dev_addr_length = I2C_ADDR_BIT_7,
+        .device_address = i2c_device_address,
+        .scl_speed_hz = i2c_scl_speed_hz};
+    i2c_master_dev_handle_t i2c_master_dev;
+    ret = i2c_master_bus_add_device(i2c_master_bus, &i2c_device_config, &i2c_master_dev);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to add I2C SSD1306 device");
+        return ret;
+    }
+
+    transport->transmit = ssd1306_i2c_transmit;
+    transport->deinit = ssd1306_i2c_deinit;
+    transport->ctx = i2c_master_dev;
+
+    return ret;
+}
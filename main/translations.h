@@ -65,7 +65,7 @@ static const translations_t translations_es = {
     .starting = "Iniciando...",
     .set_temp = "Temperatura Configurada:",
     .current_temp = "Temperatura Actual:",
-    .mode_cool = "Frio",
+    .mode_cool = "Frío",
     .mode_heat = "Calor",
     .mode_off = "Apagado",
     .control_active = "Control Activo",
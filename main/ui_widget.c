@@ -0,0 +1,39 @@
+#include "ui_widget.h"
+#include "ssd1306.h"
+
+static const char *TAG = "UI_WIDGET";
+
+#define UI_WIDGET_TEXT_SIZE 32
+
+// Re-render the widget if its value changed
+bool ui_widget_update(ui_widget_t *widget, int32_t value)
+{
+    if (widget->valid && widget->value == value) {
+        return false;
+    }
+
+    // Clear only the widget's own rectangle, the rest of the frame is retained
+    ssd1306_fill_area(widget->x, widget->x + widget->width - 1,
+                      widget->y, widget->y + widget->height - 1, false);
+
+    if (value != UI_WIDGET_HIDDEN) {
+        char text[UI_WIDGET_TEXT_SIZE];
+        widget->format(text, sizeof(text), value);
+        // Clipped to the rectangle, a neighbour overwritten by a long text would not be redrawn
+        if (text[0] != '\0') {
+            ssd1306_print_str_clipped(widget->x, widget->y, text, widget->scale ? widget->scale : 1, widget->width, false);
+        }
+    }
+
+    widget->value = value;
+    widget->valid = true;
+    ESP_LOGD(TAG, "Widget '%s' redrawn", widget->name);
+
+    return true;
+}
+
+// Force the widget to be redrawn on its next update
+void ui_widget_invalidate(ui_widget_t *widget)
+{
+    widget->valid = false;
+}
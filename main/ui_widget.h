@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Value that blanks a widget's rectangle instead of rendering it
+#define UI_WIDGET_HIDDEN INT32_MIN
+
+// Formats a widget value into its display text
+typedef void (*ui_widget_format_t)(char *text, size_t size, int32_t value);
+
+// Retained display region bound to an integer value
+typedef struct {
+    const char *name;
+    uint8_t x;
+    uint8_t y;
+    uint8_t width;
+    uint8_t height;
+    uint8_t scale;          // Text scale factor, 0 draws normal size text
+    ui_widget_format_t format;
+    int32_t value;          // Last rendered value
+    bool valid;             // False until the widget has been rendered once
+} ui_widget_t;
+
+// Re-render the widget if its value changed, its text clipped to the widget's width. Must be called
+// inside a display frame. Returns true if the widget's rectangle was redrawn.
+bool ui_widget_update(ui_widget_t *widget, int32_t value);
+
+// Force the widget to be redrawn on its next update
+void ui_widget_invalidate(ui_widget_t *widget);
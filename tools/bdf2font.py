@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""Convert a BDF bitmap font into the sparse SSD1306 glyph table used by main/ssd1306.c.
+
+Glyphs are stored column-major, one byte per column with bit 0 at the top row, which is the layout of a display page. Only the
+encodings present in the BDF file are emitted, grouped into contiguous code point ranges, so unused control characters and empty
+Latin-1 slots cost no flash.
+
+With --proportional every glyph is trimmed to its inked columns and gets its own advance, one blank column wider than the ink.
+Digits share a single advance so numeric readouts do not shift when their value changes.
+"""
+
+import argparse
+import os
+import sys
+
+CELL_SIZE = 8
+SPACING = 1
+
+
+def parse_bdf(path):
+    font = {"glyphs": {}}
+    glyph = None
+    bitmap = None
+    with open(path, encoding="latin-1") as bdf:
+        for line in bdf:
+            fields = line.split()
+            if not fields:
+                continue
+            keyword = fields[0]
+            if bitmap is not None:
+                if keyword == "ENDCHAR":
+                    glyph["bitmap"] = bitmap
+                    if glyph["encoding"] >= 0:
+                        font["glyphs"][glyph["encoding"]] = glyph
+                    glyph = None
+                    bitmap = None
+                else:
+                    bitmap.append(int(keyword, 16))
+            elif keyword == "FONTBOUNDINGBOX":
+                font["bbx"] = tuple(int(v) for v in fields[1:5])
+            elif keyword == "DEFAULT_CHAR":
+                font["default_char"] = int(fields[1])
+            elif keyword == "STARTCHAR":
+                glyph = {"name": fields[1] if len(fields) > 1 else ""}
+            elif keyword == "ENCODING":
+                glyph["encoding"] = int(fields[1])
+            elif keyword == "DWIDTH":
+                glyph["dwidth"] = int(fields[1])
+            elif keyword == "BBX":
+                glyph["bbx"] = tuple(int(v) for v in fields[1:5])
+            elif keyword == "BITMAP":
+                bitmap = []
+    if "bbx" not in font:
+        sys.exit("%s: missing FONTBOUNDINGBOX" % path)
+    return font
+
+
+def glyph_columns(font, glyph):
+    """Rasterize a BDF glyph into CELL_SIZE column bytes aligned to the font bounding box."""
+    font_width, font_height, font_x, font_y = font["bbx"]
+    if font_height > CELL_SIZE:
+        sys.exit("font height %d does not fit in a %d pixel page" % (font_height, CELL_SIZE))
+    ascent = font_height + font_y
+    width, height, x_offset, y_offset = glyph["bbx"]
+    row_bytes = (width + 7) // 8
+    columns = [0] * CELL_SIZE
+    for row, bits in enumerate(glyph["bitmap"][:height]):
+        cell_row = ascent - 1 - (y_offset + height - 1 - row)
+        for col in range(width):
+            if bits >> (row_bytes * 8 - 1 - col) & 1:
+                cell_col = x_offset - font_x + col
+                if not (0 <= cell_col < CELL_SIZE and 0 <= cell_row < CELL_SIZE):
+                    sys.exit("glyph %s has ink outside the %dx%d cell" % (glyph["name"], CELL_SIZE, CELL_SIZE))
+                columns[cell_col] |= 1 << cell_row
+    return columns
+
+
+def ink_span(columns):
+    inked = [i for i, col in enumerate(columns) if col]
+    return (inked[0], inked[-1]) if inked else None
+
+
+def build_table(font, proportional):
+    encodings = sorted(font["glyphs"])
+    columns = {enc: glyph_columns(font, font["glyphs"][enc]) for enc in encodings}
+    advances = {enc: min(font["glyphs"][enc].get("dwidth", CELL_SIZE), CELL_SIZE) for enc in encodings}
+
+    if proportional:
+        digits = [enc for enc in range(ord("0"), ord("9") + 1) if enc in columns and ink_span(columns[enc])]
+        digit_first = min((ink_span(columns[d])[0] for d in digits), default=0)
+        digit_last = max((ink_span(columns[d])[1] for d in digits), default=CELL_SIZE - 1)
+        for enc in encodings:
+            if enc in digits:
+                first, last = digit_first, digit_last
+            else:
+                span = ink_span(columns[enc])
+                if span is None:
+                    advances[enc] = max(1, advances[enc] // 2)
+                    continue
+                first, last = span
+            columns[enc] = columns[enc][first:] + [0] * first
+            advances[enc] = min(last - first + 1 + SPACING, CELL_SIZE)
+
+    ranges = []
+    for enc in encodings:
+        if ranges and ranges[-1][1] == enc - 1:
+            ranges[-1][1] = enc
+        else:
+            ranges.append([enc, enc])
+
+    default_char = font.get("default_char", ord("?"))
+    fallback = encodings.index(default_char) if default_char in columns else 0
+    return encodings, columns, advances, ranges, fallback
+
+
+def glyph_label(enc):
+    char = chr(enc)
+    return char if char.isprintable() and char not in "\\" else "0x%02X" % enc
+
+
+def emit_c(path, name, source, encodings, columns, advances, ranges, fallback, proportional):
+    lines = [
+        "/* Generated by tools/bdf2font.py from %s, do not edit. */" % os.path.basename(source),
+        "",
+        '#include "ssd1306_font.h"',
+        "",
+        "static const ssd1306_font_range_t %s_ranges[] = {" % name,
+    ]
+    index = 0
+    for first, last in ranges:
+        lines.append("    {0x%04X, 0x%04X, %d}," % (first, last, index))
+        index += last - first + 1
+    lines += ["};", "", "static const uint8_t %s_glyphs[][SSD1306_FONT_CELL_SIZE] = {" % name]
+    for enc in encodings:
+        data = ", ".join("0x%02X" % col for col in columns[enc])
+        lines.append("    {%s}, // U+%04X (%s)" % (data, enc, glyph_label(enc)))
+    lines += ["};", ""]
+    if proportional:
+        lines.append("static const uint8_t %s_advance[] = {" % name)
+        for start in range(0, len(encodings), 16):
+            lines.append("    " + ", ".join(str(advances[enc]) for enc in encodings[start:start + 16]) + ",")
+        lines += ["};", ""]
+    lines += [
+        "const ssd1306_font_t %s = {" % name,
+        "    .ranges = %s_ranges," % name,
+        "    .total_ranges = %d," % len(ranges),
+        "    .glyphs = %s_glyphs," % name,
+        "    .advance = %s," % ("%s_advance" % name if proportional else "NULL"),
+        "    .width = %d," % CELL_SIZE,
+        "    .fallback = %d};" % fallback,
+    ]
+    with open(path, "w", encoding="utf-8") as out:
+        out.write("\n".join(lines) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("bdf", help="source BDF font")
+    parser.add_argument("output", help="generated C source")
+    parser.add_argument("--name", required=True, help="name of the generated ssd1306_font_t")
+    parser.add_argument("--proportional", action="store_true", help="trim glyphs and emit per-glyph advances")
+    args = parser.parse_args()
+
+    font = parse_bdf(args.bdf)
+    encodings, columns, advances, ranges, fallback = build_table(font, args.proportional)
+    emit_c(args.output, args.name, args.bdf, encodings, columns, advances, ranges, fallback, args.proportional)
+
+
+if __name__ == "__main__":
+    main()